@@ -0,0 +1,140 @@
+// Times LLMEngine's single-pass JSON reader against the std::regex parser it
+// replaced, on model answers built from the effects' parameter tables.
+//
+//   cmake -B build -DCMAKE_BUILD_TYPE=Release -DINCANT_BUILD_BENCH=ON
+//   cmake --build build --target incant_parse_bench
+//   build/bench/incant_parse_bench
+
+#include "JsonReader.h"
+#include "ParameterDescriptors.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <regex>
+#include <string>
+
+namespace incant {
+
+namespace {
+
+// The parser as it was before readJsonObject: one regex per key, each
+// searching the whole answer
+namespace regex_parser {
+
+std::string extractJsonObject(const std::string& text) {
+    auto start = text.find('{');
+    auto end = text.rfind('}');
+    if (start == std::string::npos || end == std::string::npos || end <= start) {
+        return {};
+    }
+    return text.substr(start, end - start + 1);
+}
+
+bool extractFloat(const std::string& json, const std::string& key, float& value) {
+    std::regex pattern("\"" + key + "\"\\s*:\\s*([-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?)");
+    std::smatch match;
+    if (!std::regex_search(json, match, pattern)) {
+        return false;
+    }
+    try {
+        value = std::stof(match[1].str());
+    } catch (...) {
+        return false;
+    }
+    value = std::clamp(value, 0.0f, 1.0f);
+    return true;
+}
+
+template <typename Params>
+bool parse(const std::string& output, Params& params) {
+    std::string json = extractJsonObject(output);
+    if (json.empty()) {
+        return false;
+    }
+    bool found = false;
+    for (int i = 0; i < numParameters<Params>(); ++i) {
+        const auto* descriptor = findParameter<Params>(i);
+        found |= extractFloat(json, descriptor->key, *parameterField(params, i));
+    }
+    return found;
+}
+
+} // namespace regex_parser
+
+// A grammar-shaped answer setting the first count keys of the table
+template <typename Params>
+std::string makeAnswer(int count) {
+    std::string answer = "{";
+    for (int i = 0; i < count; ++i) {
+        char value[16];
+        std::snprintf(value, sizeof(value), "%.3f", static_cast<float>((i * 37) % 1000) / 1000.0f);
+        answer.append(i > 0 ? ", \"" : "\"").append(findParameter<Params>(i)->key).append("\": ").append(value);
+    }
+    return answer.append("}");
+}
+
+// Mean time per call in nanoseconds, running fn for about minSeconds
+template <typename Fn>
+double timePerCall(Fn&& fn, double minSeconds = 0.5) {
+    using Clock = std::chrono::steady_clock;
+    long calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        for (int i = 0; i < 16; ++i) {
+            fn();
+        }
+        calls += 16;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < minSeconds);
+    return elapsed.count() * 1.0e9 / static_cast<double>(calls);
+}
+
+volatile float sink = 0.0f;
+
+template <typename Params>
+bool runCase(const char* name, int count) {
+    const std::string answer = makeAnswer<Params>(count);
+
+    // Both parsers have to agree before their timings mean anything
+    Params expected{};
+    Params actual{};
+    regex_parser::parse(answer, expected);
+    readJsonObject(answer, actual);
+    for (int i = 0; i < numParameters<Params>(); ++i) {
+        if (*parameterField(expected, i) != *parameterField(actual, i)) {
+            std::printf("%-28s MISMATCH on \"%s\"\n", name, findParameter<Params>(i)->key);
+            return false;
+        }
+    }
+
+    const double regexNs = timePerCall([&answer] {
+        Params params{};
+        regex_parser::parse(answer, params);
+        sink = sink + *parameterField(params, 0);
+    });
+    const double readerNs = timePerCall([&answer] {
+        Params params{};
+        readJsonObject(answer, params);
+        sink = sink + *parameterField(params, 0);
+    });
+
+    std::printf("%-28s %4d keys %12.0f ns %10.0f ns %8.1fx\n", name, count, regexNs, readerNs, regexNs / readerNs);
+    return true;
+}
+
+} // namespace
+
+} // namespace incant
+
+int main() {
+    using namespace incant;
+
+    std::printf("%-28s %9s %15s %13s %9s\n", "answer", "", "regex", "reader", "speedup");
+    bool ok = true;
+    ok &= runCase<EQParams>("EQ, every key", numParameters<EQParams>());
+    ok &= runCase<EQParams>("EQ, six keys", 6);
+    ok &= runCase<CompressorParams>("Compressor, every key", numParameters<CompressorParams>());
+    ok &= runCase<ReverbParams>("Reverb, every key", numParameters<ReverbParams>());
+    return ok ? 0 : 1;
+}
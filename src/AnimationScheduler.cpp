@@ -0,0 +1,87 @@
+#include "AnimationScheduler.h"
+#include <algorithm>
+
+namespace incant {
+
+namespace {
+
+// Longest step handed to clients, so a stall doesn't make animations jump
+constexpr double kMaxFrameStep = 0.25;
+
+} // namespace
+
+AnimationScheduler::AnimationScheduler(juce::Component& owner)
+    : owner_(owner)
+{
+    wake();
+}
+
+AnimationScheduler::~AnimationScheduler() {
+    stopTimer();
+    vblank_ = juce::VBlankAttachment();
+}
+
+void AnimationScheduler::addClient(Client& client) {
+    if (std::find(clients_.begin(), clients_.end(), &client) == clients_.end()) {
+        clients_.push_back(&client);
+    }
+    wake();
+}
+
+void AnimationScheduler::removeClient(Client& client) {
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), &client), clients_.end());
+}
+
+void AnimationScheduler::wake() {
+    quietTime_ = 0.0;
+    if (!idle_ && !vblank_.isEmpty()) return;
+
+    idle_ = false;
+    stopTimer();
+    lastFrameTime_ = nowSeconds();
+    vblank_ = juce::VBlankAttachment(&owner_, [this] { onVBlank(); });
+}
+
+void AnimationScheduler::goIdle() {
+    idle_ = true;
+    vblank_ = juce::VBlankAttachment();
+    startTimerHz(kIdleProbeHz);
+}
+
+void AnimationScheduler::onVBlank() {
+    // Fast displays get every other vblank or so
+    const double now = nowSeconds();
+    if (now - lastFrameTime_ < 0.9 / kFrameRateHz) return;
+
+    const bool changed = runFrame(now);
+    quietTime_ = changed ? 0.0 : quietTime_ + 1.0 / kFrameRateHz;
+
+    if (quietTime_ >= kIdleAfterSeconds || !owner_.isShowing()) {
+        goIdle();
+    }
+}
+
+void AnimationScheduler::timerCallback() {
+    // Idle probe: still tick the clients so they notice new input
+    const bool changed = runFrame(nowSeconds());
+    if (changed && owner_.isShowing()) {
+        wake();
+    }
+}
+
+bool AnimationScheduler::runFrame(double now) {
+    const double delta = juce::jlimit(0.0, kMaxFrameStep, now - lastFrameTime_);
+    lastFrameTime_ = now;
+
+    bool changed = false;
+    for (auto* client : clients_) {
+        changed |= client->advanceFrame(delta);
+    }
+    return changed;
+}
+
+double AnimationScheduler::nowSeconds() {
+    return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+} // namespace incant
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+namespace incant {
+
+// One frame clock for everything animated in an editor.
+//
+// Frames follow the display's vertical blank (capped at kFrameRateHz), so all
+// clients advance together and their repaints land in the same paint pass.
+// When no client reports a change for a while, or the editor isn't showing,
+// the vblank callback is detached and a slow probe timer takes over; the first
+// probe that sees a change brings back full-rate frames.
+class AnimationScheduler : private juce::Timer {
+public:
+    static constexpr double kFrameRateHz = 60.0;
+    static constexpr int kIdleProbeHz = 5;
+    static constexpr double kIdleAfterSeconds = 0.5;
+
+    class Client {
+    public:
+        virtual ~Client() = default;
+
+        // Advances by deltaSeconds and repaints whatever changed.
+        // Returns false when nothing did, so the scheduler can go idle.
+        virtual bool advanceFrame(double deltaSeconds) = 0;
+    };
+
+    explicit AnimationScheduler(juce::Component& owner);
+    ~AnimationScheduler() override;
+
+    void addClient(Client& client);
+    void removeClient(Client& client);
+
+    // Back to full rate immediately, e.g. on user interaction
+    void wake();
+
+private:
+    void timerCallback() override;
+    void onVBlank();
+    bool runFrame(double nowSeconds);
+    void goIdle();
+
+    static double nowSeconds();
+
+    juce::Component& owner_;
+    juce::VBlankAttachment vblank_;
+    std::vector<Client*> clients_;
+
+    double lastFrameTime_ = 0.0;
+    double quietTime_ = 0.0;
+    bool idle_ = false;
+};
+
+} // namespace incant
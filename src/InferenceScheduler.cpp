@@ -0,0 +1,628 @@
+#include "InferenceScheduler.h"
+
+#ifdef USE_LLAMA_CPP
+
+#include "llama.h"
+#include "ggml-cpu.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace incant {
+
+namespace {
+
+constexpr int kBatchSize = 512;
+
+// Sequences are sized in steps of this many tokens, so slightly longer
+// prompts don't reallocate the context
+constexpr int kContextGranularity = 256;
+
+// Token generation is memory bound and stops scaling around here
+constexpr int kMaxDecodeThreads = 4;
+
+int readEnvInt(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    if (!value || *value == '\0') {
+        return fallback;
+    }
+    char* end = nullptr;
+    const long parsed = std::strtol(value, &end, 10);
+    return *end == '\0' ? static_cast<int>(parsed) : fallback;
+}
+
+int getHardwareThreads() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+} // namespace
+
+struct InferenceScheduler::Job {
+    Request request;
+    std::promise<std::string> result;
+    std::uint64_t order = 0;
+
+    // Prompt, then every token generated so far
+    std::vector<llama_token> tokens;
+    int decoded = 0;            // tokens already in the KV cache
+    int snapshotAt = -1;        // head length, while the head still needs a snapshot
+    int generated = 0;
+    std::string output;
+
+    bool isCancelled() const { return request.cancel && request.cancel->load(); }
+};
+
+struct InferenceScheduler::Runner {
+    struct Head {
+        std::vector<llama_token> tokens;
+        std::vector<uint8_t> state;     // sequence state right after the head
+    };
+
+    struct Slot {
+        std::unique_ptr<Job> job;
+        int loadedHead = -1;            // head key at the start of the sequence
+    };
+
+    explicit Runner(std::shared_ptr<llama_model> m)
+        : model(std::move(m)),
+          vocab(llama_model_get_vocab(model.get())),
+          batch(llama_batch_init(kBatchSize, 0, 1))
+    {
+    }
+
+    ~Runner() {
+        for (auto& slot : slots) {
+            if (slot.job) {
+                slot.job->result.set_value({});
+            }
+        }
+        llama_batch_free(batch);
+        if (context) {
+            llama_free(context);
+        }
+    }
+
+    bool isIdle() const {
+        return std::none_of(slots.begin(), slots.end(), [](const Slot& slot) { return slot.job != nullptr; });
+    }
+
+    bool resize(int tokens, const ThreadSettings& threads) {
+        if (context) {
+            llama_free(context);
+            context = nullptr;
+        }
+        for (auto& slot : slots) {
+            slot.loadedHead = -1;
+        }
+
+        sequenceTokens = (tokens + kContextGranularity - 1) / kContextGranularity * kContextGranularity;
+
+        llama_context_params params = llama_context_default_params();
+        params.n_ctx = static_cast<uint32_t>(sequenceTokens * kMaxSequences);
+        params.n_batch = kBatchSize;
+        params.n_seq_max = kMaxSequences;
+        params.n_threads = threads.decodeThreads;
+        params.n_threads_batch = threads.batchThreads;
+
+        context = llama_init_from_model(model.get(), params);
+        if (!context) {
+            sequenceTokens = 0;
+        }
+        return context != nullptr;
+    }
+
+    // A free sequence, preferably one that already holds the job's head
+    int findSlot(int headKey) const {
+        int fallback = -1;
+        for (int s = 0; s < kMaxSequences; ++s) {
+            const auto& slot = slots[static_cast<size_t>(s)];
+            if (slot.job) continue;
+            if (headKey >= 0 && slot.loadedHead == headKey) return s;
+            if (fallback < 0 || slot.loadedHead < 0) fallback = s;
+        }
+        return fallback;
+    }
+
+    void start(int s, std::unique_ptr<Job> job) {
+        auto& slot = slots[static_cast<size_t>(s)];
+        auto& request = job->request;
+        auto* memory = llama_get_memory(context);
+
+        Head* head = nullptr;
+        if (request.headKey >= 0) {
+            head = &heads[request.headKey];
+            if (head->tokens != request.head) {
+                head->tokens = request.head;
+                head->state.clear();
+            }
+        }
+        const int headSize = static_cast<int>(request.head.size());
+
+        job->tokens = request.head;
+        job->tokens.insert(job->tokens.end(), request.tail.begin(), request.tail.end());
+        job->decoded = 0;
+        job->snapshotAt = -1;
+
+        if (head && slot.loadedHead == request.headKey && llama_memory_seq_rm(memory, s, headSize, -1)) {
+            // The sequence's last job used the same head: drop only what followed it
+            job->decoded = headSize;
+        } else {
+            llama_memory_seq_rm(memory, s, -1, -1);
+            slot.loadedHead = -1;
+            if (head && restoreHead(*head, s, request.headFile)) {
+                job->decoded = headSize;
+            } else if (head) {
+                job->snapshotAt = headSize;
+            }
+        }
+        if (job->decoded > 0) {
+            slot.loadedHead = request.headKey;
+        }
+
+        slot.job = std::move(job);
+        if (slot.job->decoded == static_cast<int>(slot.job->tokens.size())) {
+            // Nothing left to decode, e.g. a warm-up of a head already cached
+            finish(slot);
+        }
+    }
+
+    bool restoreHead(Head& head, int s, const std::string& file) {
+        auto* memory = llama_get_memory(context);
+
+        if (head.state.empty() && !file.empty()) {
+            // Saved by an earlier session; only trusted if it holds exactly this head
+            std::vector<llama_token> saved(head.tokens.size() + 1);
+            size_t savedCount = 0;
+            if (llama_state_seq_load_file(context, file.c_str(), s, saved.data(), saved.size(), &savedCount) != 0
+                    && savedCount == head.tokens.size()
+                    && std::equal(head.tokens.begin(), head.tokens.end(), saved.begin())) {
+                takeSnapshot(head, s);
+                return true;
+            }
+            llama_memory_seq_rm(memory, s, -1, -1);
+        }
+
+        if (head.state.empty()) {
+            return false;
+        }
+        if (llama_state_seq_set_data(context, head.state.data(), head.state.size(), s) != 0) {
+            return true;
+        }
+
+        // Stale snapshot: prefill the head again and retake it
+        head.state.clear();
+        llama_memory_seq_rm(memory, s, -1, -1);
+        return false;
+    }
+
+    void takeSnapshot(Head& head, int s) {
+        head.state.resize(llama_state_seq_get_size(context, s));
+        llama_state_seq_get_data(context, head.state.data(), head.state.size(), s);
+    }
+
+    void finish(Slot& slot) {
+        slot.job->result.set_value(std::move(slot.job->output));
+        slot.job.reset();
+    }
+
+    // One decode for every active sequence
+    void step(const ThreadSettings& threads) {
+        // Generating sequences first, one token each; then prompts by priority
+        std::array<int, kMaxSequences> order{};
+        int active = 0;
+        for (int s = 0; s < kMaxSequences; ++s) {
+            if (slots[static_cast<size_t>(s)].job) order[static_cast<size_t>(active++)] = s;
+        }
+        std::sort(order.begin(), order.begin() + active, [this](int a, int b) {
+            const auto& jobA = *slots[static_cast<size_t>(a)].job;
+            const auto& jobB = *slots[static_cast<size_t>(b)].job;
+            const bool generatingA = jobA.generated > 0;
+            const bool generatingB = jobB.generated > 0;
+            if (generatingA != generatingB) return generatingA;
+            if (jobA.request.priority != jobB.request.priority) return jobA.request.priority > jobB.request.priority;
+            return jobA.order < jobB.order;
+        });
+
+        std::array<int, kMaxSequences> logitsIndex{};
+        std::array<int, kMaxSequences> chunk{};
+        logitsIndex.fill(-1);
+        batch.n_tokens = 0;
+
+        for (int i = 0; i < active; ++i) {
+            const int s = order[static_cast<size_t>(i)];
+            auto& job = *slots[static_cast<size_t>(s)].job;
+
+            int end = static_cast<int>(job.tokens.size());
+            if (job.snapshotAt > job.decoded) {
+                end = std::min(end, job.snapshotAt);
+            }
+            const int count = std::min(end - job.decoded, kBatchSize - batch.n_tokens);
+            chunk[static_cast<size_t>(s)] = count;
+
+            for (int t = 0; t < count; ++t) {
+                const int n = batch.n_tokens++;
+                const int position = job.decoded + t;
+                batch.token[n] = job.tokens[static_cast<size_t>(position)];
+                batch.pos[n] = position;
+                batch.n_seq_id[n] = 1;
+                batch.seq_id[n][0] = s;
+                batch.logits[n] = 0;
+            }
+
+            // Logits only where the next token gets sampled
+            if (count > 0 && job.decoded + count == static_cast<int>(job.tokens.size())
+                    && job.generated < job.request.maxTokens) {
+                batch.logits[batch.n_tokens - 1] = 1;
+                logitsIndex[static_cast<size_t>(s)] = batch.n_tokens - 1;
+            }
+        }
+
+        if (batch.n_tokens == 0) {
+            return;
+        }
+
+        llama_set_n_threads(context, threads.decodeThreads, threads.batchThreads);
+        if (llama_decode(context, batch) != 0) {
+            // Drop every job in the batch; their sequences start over
+            for (int i = 0; i < active; ++i) {
+                auto& slot = slots[static_cast<size_t>(order[static_cast<size_t>(i)])];
+                slot.job->output.clear();
+                slot.loadedHead = -1;
+                finish(slot);
+            }
+            return;
+        }
+
+        for (int i = 0; i < active; ++i) {
+            const int s = order[static_cast<size_t>(i)];
+            auto& slot = slots[static_cast<size_t>(s)];
+            auto& job = *slot.job;
+            job.decoded += chunk[static_cast<size_t>(s)];
+
+            if (job.decoded == job.snapshotAt) {
+                auto& head = heads[job.request.headKey];
+                takeSnapshot(head, s);
+                if (!job.request.headFile.empty()) {
+                    llama_state_seq_save_file(context, job.request.headFile.c_str(), s,
+                        head.tokens.data(), head.tokens.size());
+                }
+                slot.loadedHead = job.request.headKey;
+                job.snapshotAt = -1;
+            }
+
+            if (job.isCancelled()) {
+                job.output.clear();
+                finish(slot);
+                continue;
+            }
+
+            const int index = logitsIndex[static_cast<size_t>(s)];
+            if (index < 0) {
+                // Still prefilling, or a prefill-only request that is done
+                if (job.decoded == static_cast<int>(job.tokens.size())) {
+                    finish(slot);
+                }
+                continue;
+            }
+
+            const llama_token token = llama_sampler_sample(job.request.sampler, context, index);
+            ++job.generated;
+            if (llama_vocab_is_eog(vocab, token)) {
+                finish(slot);
+                continue;
+            }
+
+            char buf[256];
+            const int n = llama_token_to_piece(vocab, token, buf, sizeof(buf), 0, true);
+            if (n > 0) {
+                job.output.append(buf, static_cast<size_t>(n));
+            }
+
+            const bool stopped = job.request.stopCharacter != '\0'
+                && !job.output.empty() && job.output.back() == job.request.stopCharacter;
+            if (stopped || job.generated >= job.request.maxTokens) {
+                finish(slot);
+                continue;
+            }
+            job.tokens.push_back(token);
+        }
+    }
+
+    std::shared_ptr<llama_model> model;
+    const llama_vocab* vocab = nullptr;
+    llama_context* context = nullptr;
+    llama_batch batch;
+    int sequenceTokens = 0;
+    std::array<Slot, kMaxSequences> slots;
+    std::map<int, Head> heads;
+};
+
+std::shared_ptr<InferenceScheduler> InferenceScheduler::acquire() {
+    static std::mutex mutex;
+    static std::weak_ptr<InferenceScheduler> current;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto scheduler = current.lock();
+    if (!scheduler) {
+        scheduler = std::shared_ptr<InferenceScheduler>(new InferenceScheduler(), [](InferenceScheduler* s) { delete s; });
+        current = scheduler;
+    }
+    return scheduler;
+}
+
+InferenceScheduler::InferenceScheduler()
+    : threadSettings_(getDefaultThreadSettings())
+{
+}
+
+InferenceScheduler::~InferenceScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        wake_.notify_one();
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+InferenceScheduler::ThreadSettings InferenceScheduler::getDefaultThreadSettings() {
+    const int available = std::max(1, getHardwareThreads() / 2);
+
+    ThreadSettings settings;
+    settings.decodeThreads = readEnvInt("INCANT_LLM_THREADS", std::min(available, kMaxDecodeThreads));
+    settings.batchThreads = readEnvInt("INCANT_LLM_BATCH_THREADS", available);
+    settings.reservedCores = readEnvInt("INCANT_LLM_RESERVED_CORES", 0);
+    return settings;
+}
+
+void InferenceScheduler::setThreadSettings(const ThreadSettings& settings) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threadSettings_ = settings;
+    threadSettingsChanged_ = true;
+}
+
+InferenceScheduler::ThreadSettings InferenceScheduler::getThreadSettings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threadSettings_;
+}
+
+void InferenceScheduler::setBackgroundPriority() {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#else
+    // Per thread on Linux
+    setpriority(PRIO_PROCESS, 0, 10);
+#endif
+}
+
+std::future<std::string> InferenceScheduler::submit(Request request) {
+    auto job = std::make_unique<Job>();
+    job->request = std::move(request);
+    auto future = job->result.get_future();
+
+    if (!job->request.model || (!job->request.sampler && job->request.maxTokens > 0)) {
+        job->result.set_value({});
+        return future;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->order = nextOrder_++;
+    submitted_.push_back(std::move(job));
+
+    if (!running_) {
+        // The previous worker has returned (or never ran)
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+        running_ = true;
+        worker_ = std::thread([this] { run(); });
+    }
+    wake_.notify_one();
+    return future;
+}
+
+void InferenceScheduler::release(std::shared_ptr<llama_model>& model) {
+    model.reset();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseRequested_ = true;
+    wake_.notify_one();
+}
+
+bool InferenceScheduler::hasWork() const {
+    return !waiting_.empty()
+        || std::any_of(runners_.begin(), runners_.end(), [](const auto& runner) { return !runner->isIdle(); });
+}
+
+void InferenceScheduler::run() {
+    setBackgroundPriority();
+
+    for (;;) {
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !submitted_.empty() || releaseRequested_ || hasWork(); });
+            stop = stopping_;
+            releaseRequested_ = false;
+            for (auto& job : submitted_) {
+                waiting_.push_back(std::move(job));
+            }
+            submitted_.clear();
+        }
+
+        if (stop) {
+            // The last holder is going: fail what is left and free every
+            // context while the model handles are still good
+            for (auto& job : waiting_) {
+                job->result.set_value({});
+            }
+            waiting_.clear();
+            runners_.clear();
+            freeThreadPools();
+            return;
+        }
+
+        updateThreadPools();
+        admitWaiting();
+
+        for (auto& runner : runners_) {
+            if (!runner->isIdle()) {
+                runner->step(activeSettings_);
+            }
+        }
+
+        freeUnusedRunners();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (submitted_.empty() && !hasWork() && runners_.empty()) {
+            // No compute threads linger while nothing is loaded
+            freeThreadPools();
+            threadSettingsChanged_ = true;
+            running_ = false;
+            return;
+        }
+    }
+}
+
+void InferenceScheduler::admitWaiting() {
+    // Highest priority first, oldest first within a priority
+    std::sort(waiting_.begin(), waiting_.end(), [](const auto& a, const auto& b) {
+        if (a->request.priority != b->request.priority) return a->request.priority > b->request.priority;
+        return a->order < b->order;
+    });
+
+    for (auto it = waiting_.begin(); it != waiting_.end();) {
+        auto& job = **it;
+        Runner* runner = job.isCancelled() ? nullptr : getRunner(job.request.model);
+        if (!runner) {
+            job.result.set_value({});
+            it = waiting_.erase(it);
+            continue;
+        }
+
+        // A longer prompt than the context was sized for: grow it once the
+        // sequences in flight have finished
+        if (job.request.contextTokens > runner->sequenceTokens) {
+            if (!runner->isIdle()) {
+                ++it;
+                continue;
+            }
+            if (!runner->resize(job.request.contextTokens, activeSettings_)) {
+                job.result.set_value({});
+                it = waiting_.erase(it);
+                continue;
+            }
+            attachThreadPools(*runner);
+        }
+
+        const int s = runner->findSlot(job.request.headKey);
+        if (s < 0) {
+            ++it;
+            continue;
+        }
+        runner->start(s, std::move(*it));
+        it = waiting_.erase(it);
+    }
+}
+
+InferenceScheduler::Runner* InferenceScheduler::getRunner(const std::shared_ptr<llama_model>& model) {
+    for (auto& runner : runners_) {
+        if (runner->model == model) return runner.get();
+    }
+
+    // Sequences are batched through the KV cache; encoder-decoder models
+    // would need their encoder output batched as well
+    if (llama_model_has_encoder(model.get())) {
+        return nullptr;
+    }
+
+    runners_.push_back(std::make_unique<Runner>(model));
+    return runners_.back().get();
+}
+
+void InferenceScheduler::updateThreadPools() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!threadSettingsChanged_) {
+            return;
+        }
+        activeSettings_ = threadSettings_;
+        threadSettingsChanged_ = false;
+    }
+
+    const int hardwareThreads = getHardwareThreads();
+    activeSettings_.decodeThreads = std::clamp(activeSettings_.decodeThreads, 1, hardwareThreads);
+    activeSettings_.batchThreads = std::clamp(activeSettings_.batchThreads, 1, hardwareThreads);
+    activeSettings_.reservedCores = std::clamp(activeSettings_.reservedCores, 0, hardwareThreads - 1);
+
+    freeThreadPools();
+
+    // Low priority, sleeping rather than spinning between graph nodes, and
+    // optionally kept off the cores reserved for the host
+    const auto makePool = [this, hardwareThreads](int threads) {
+        auto params = ggml_threadpool_params_default(threads);
+        params.prio = GGML_SCHED_PRIO_LOW;
+        params.poll = 0;
+        if (activeSettings_.reservedCores > 0) {
+            for (int core = activeSettings_.reservedCores; core < std::min(hardwareThreads, GGML_MAX_N_THREADS); ++core) {
+                params.cpumask[core] = true;
+            }
+        }
+        return ggml_threadpool_new(&params);
+    };
+    decodePool_ = makePool(activeSettings_.decodeThreads);
+    batchPool_ = activeSettings_.batchThreads == activeSettings_.decodeThreads
+        ? nullptr : makePool(activeSettings_.batchThreads);
+
+    for (auto& runner : runners_) {
+        attachThreadPools(*runner);
+    }
+}
+
+void InferenceScheduler::attachThreadPools(Runner& runner) {
+    if (!runner.context || !decodePool_) {
+        return;
+    }
+    // Without a separate batch pool llama.cpp uses the decode pool for both
+    llama_attach_threadpool(runner.context, decodePool_, batchPool_);
+}
+
+void InferenceScheduler::freeThreadPools() {
+    for (auto& runner : runners_) {
+        if (runner->context) {
+            llama_detach_threadpool(runner->context);
+        }
+    }
+    if (decodePool_) {
+        ggml_threadpool_free(decodePool_);
+        decodePool_ = nullptr;
+    }
+    if (batchPool_) {
+        ggml_threadpool_free(batchPool_);
+        batchPool_ = nullptr;
+    }
+}
+
+void InferenceScheduler::freeUnusedRunners() {
+    // Only the runner still holds the model: no instance will ask for it again
+    runners_.erase(std::remove_if(runners_.begin(), runners_.end(), [](const auto& runner) {
+        return runner->isIdle() && runner->model.use_count() == 1;
+    }), runners_.end());
+}
+
+} // namespace incant
+
+#endif
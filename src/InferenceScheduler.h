@@ -0,0 +1,132 @@
+#pragma once
+
+#ifdef USE_LLAMA_CPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct llama_model;
+struct llama_sampler;
+struct ggml_threadpool;
+
+namespace incant {
+
+// Shared queue for everything the plugin instances ask their models.
+//
+// One worker thread decodes for every instance. Requests for the same model
+// share one llama_context with a sequence each, and every step decodes a
+// single llama_batch holding all active sequences: the next token of those
+// that are generating, then prompt chunks for new ones in priority order.
+// Only one decode runs at a time, on one pool of low-priority compute
+// threads, so however many instances cast at once inference never uses more
+// than ThreadSettings allows.
+//
+// Prompts come as a head and a tail. A head (the fixed part of an effect's
+// prompt) is prefilled once per model; later requests restore it from a
+// snapshot, or keep it in place when their sequence already holds it.
+//
+// Instances hold the scheduler through acquire(). It is created by the first
+// and stopped by the last to let go, so its worker is never left for static
+// destruction (which runs at plugin unload, under the loader lock on Windows).
+class InferenceScheduler {
+public:
+    static constexpr int kMaxSequences = 4;
+
+    enum class Priority {
+        Background,     // warm-ups
+        Normal,
+        Focused         // cast from the editor the user is working in
+    };
+
+    struct Request {
+        std::shared_ptr<llama_model> model;
+        std::vector<int32_t> head;          // llama_tokens
+        std::vector<int32_t> tail;
+        int headKey = -1;                   // names the head in the cache, -1 to not cache it
+        std::string headFile;               // where its snapshot persists, empty for nowhere
+        llama_sampler* sampler = nullptr;   // the caller's, used by this request only
+        int maxTokens = 0;                  // 0 only prefills
+        int contextTokens = 0;              // room the sequence needs
+        char stopCharacter = '\0';          // generation ends once the text ends with it
+        Priority priority = Priority::Normal;
+        const std::atomic<bool>* cancel = nullptr;
+    };
+
+    struct ThreadSettings {
+        int decodeThreads = 1;      // generating, one token per sequence
+        int batchThreads = 1;       // prefilling prompts
+        int reservedCores = 0;      // logical cores 0..N-1 are left to the host; 0 pins nothing
+    };
+
+    // Any thread. The scheduler every instance shares, created if none is
+    // held; dropping the last handle stops and joins its worker.
+    static std::shared_ptr<InferenceScheduler> acquire();
+
+    // Defaults leave half the hardware threads to the host (decode uses at
+    // most 4, where it stops getting faster) and pin nothing. Each field can
+    // be overridden with INCANT_LLM_THREADS, INCANT_LLM_BATCH_THREADS and
+    // INCANT_LLM_RESERVED_CORES.
+    static ThreadSettings getDefaultThreadSettings();
+
+    // Any thread; takes effect before the next decode
+    void setThreadSettings(const ThreadSettings& settings);
+    ThreadSettings getThreadSettings() const;
+
+    // Lowest scheduling class that still makes progress, for any thread
+    // doing inference work so it yields to the host's audio and UI threads
+    static void setBackgroundPriority();
+
+    // Any thread. The future yields the generated text, or nothing if the
+    // request failed or was cancelled.
+    std::future<std::string> submit(Request request);
+
+    // Any thread: drops a model handle. The model's context goes once no
+    // instance holds the model any more, which then frees it.
+    void release(std::shared_ptr<llama_model>& model);
+
+private:
+    struct Job;
+    struct Runner;
+
+    InferenceScheduler();
+    ~InferenceScheduler();
+
+    // Worker thread
+    void run();
+    void admitWaiting();
+    Runner* getRunner(const std::shared_ptr<llama_model>& model);
+    void freeUnusedRunners();
+    void updateThreadPools();
+    void attachThreadPools(Runner& runner);
+    void freeThreadPools();
+    bool hasWork() const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::unique_ptr<Job>> submitted_;
+    bool releaseRequested_ = false;
+    bool running_ = false;
+    bool stopping_ = false;
+    std::uint64_t nextOrder_ = 0;
+    std::thread worker_;
+    ThreadSettings threadSettings_;
+    bool threadSettingsChanged_ = true;
+
+    // Worker thread only
+    std::vector<std::unique_ptr<Job>> waiting_;
+    std::vector<std::unique_ptr<Runner>> runners_;
+    ThreadSettings activeSettings_;
+    ggml_threadpool* decodePool_ = nullptr;
+    ggml_threadpool* batchPool_ = nullptr;
+};
+
+} // namespace incant
+
+#endif
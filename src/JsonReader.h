@@ -0,0 +1,181 @@
+#pragma once
+
+#include "ParameterDescriptors.h"
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace incant {
+
+// Number at pos, advancing pos past it. JSON syntax plus a leading '+',
+// independent of the C locale. Only finite values count: nan, inf and
+// overflowing exponents read as non-numeric.
+inline bool readNumber(std::string_view text, size_t& pos, float& value) {
+    const char* first = text.data() + pos;
+    const char* last = text.data() + text.size();
+    if (first != last && *first == '+') {
+        ++first;
+    }
+
+    // from_chars also takes nan and inf; the fallback below doesn't
+    const char* lead = first != last && *first == '-' ? first + 1 : first;
+    if (lead == last || !(std::isdigit(static_cast<unsigned char>(*lead)) || *lead == '.')) {
+        return false;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    const auto [end, error] = std::from_chars(first, last, value);
+    if (error != std::errc() || !std::isfinite(value)) {
+        return false;
+    }
+    pos = static_cast<size_t>(end - text.data());
+    return true;
+#else
+    // Standard libraries without floating-point from_chars
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative) {
+        ++p;
+    }
+
+    double mantissa = 0.0;
+    int exponent = 0;
+    bool digits = false;
+    for (; p != last && std::isdigit(static_cast<unsigned char>(*p)); ++p, digits = true) {
+        mantissa = mantissa * 10.0 + (*p - '0');
+    }
+    if (p != last && *p == '.') {
+        for (++p; p != last && std::isdigit(static_cast<unsigned char>(*p)); ++p, digits = true) {
+            mantissa = mantissa * 10.0 + (*p - '0');
+            --exponent;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        const bool negativeExponent = q != last && *q == '-';
+        if (q != last && (*q == '-' || *q == '+')) {
+            ++q;
+        }
+        int written = 0;
+        bool exponentDigits = false;
+        for (; q != last && std::isdigit(static_cast<unsigned char>(*q)); ++q, exponentDigits = true) {
+            written = std::min(written * 10 + (*q - '0'), 1000);
+        }
+        if (exponentDigits) {
+            exponent += negativeExponent ? -written : written;
+            p = q;
+        }
+    }
+
+    const double magnitude = mantissa * std::pow(10.0, exponent);
+    value = static_cast<float>(negative ? -magnitude : magnitude);
+    if (!std::isfinite(value)) {
+        return false;
+    }
+    pos = static_cast<size_t>(p - text.data());
+    return true;
+#endif
+}
+
+// Which of an effect's parameters a model answer set
+template <typename Params>
+struct JsonFields {
+    std::bitset<ParameterTable<Params>::parameters.size()> present;
+    bool complete = false;      // reached the object's closing brace
+
+    bool any() const { return present.any(); }
+};
+
+// Walks the first flat JSON object in text once, without allocating. Keys
+// are matched against the effect's descriptor table and their numbers,
+// clamped to 0-1, written straight into params. Unknown keys and
+// non-numeric values are skipped; anything nested ends the read.
+template <typename Params>
+JsonFields<Params> readJsonObject(std::string_view text, Params& params) {
+    JsonFields<Params> fields;
+    size_t pos = text.find('{');
+    if (pos == std::string_view::npos) {
+        return fields;
+    }
+    ++pos;
+
+    const auto isTokenChar = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '+' || c == '-' || c == '.';
+    };
+    const auto skipSpace = [&text, &pos] {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    };
+
+    for (;;) {
+        skipSpace();
+        if (pos >= text.size()) {
+            return fields;
+        }
+        if (text[pos] == '}') {
+            fields.complete = true;
+            return fields;
+        }
+        if (text[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (text[pos] != '"') {
+            return fields;
+        }
+
+        const size_t keyEnd = text.find('"', pos + 1);
+        if (keyEnd == std::string_view::npos) {
+            return fields;
+        }
+        const auto key = text.substr(pos + 1, keyEnd - pos - 1);
+        pos = keyEnd + 1;
+
+        skipSpace();
+        if (pos >= text.size() || text[pos] != ':') {
+            return fields;
+        }
+        ++pos;
+        skipSpace();
+        if (pos >= text.size()) {
+            return fields;
+        }
+
+        float value = 0.0f;
+        if (!readNumber(text, pos, value)) {
+            // Strings, literals and non-finite numbers leave the key missing
+            if (text[pos] == '"') {
+                const size_t stringEnd = text.find('"', pos + 1);
+                if (stringEnd == std::string_view::npos) {
+                    return fields;
+                }
+                pos = stringEnd + 1;
+            } else if (isTokenChar(text[pos])) {
+                // Literals, nan and inf, and numbers out of float range
+                while (pos < text.size() && isTokenChar(text[pos])) {
+                    ++pos;
+                }
+            } else {
+                return fields;
+            }
+            continue;
+        }
+
+        for (int i = 0; i < numParameters<Params>(); ++i) {
+            if (key == findParameter<Params>(i)->key) {
+                *parameterField(params, i) = std::clamp(value, 0.0f, 1.0f);
+                fields.present.set(static_cast<size_t>(i));
+                break;
+            }
+        }
+    }
+}
+
+} // namespace incant
@@ -1,10 +1,13 @@
 #include "LLMEngine.h"
+#include "InferenceScheduler.h"
+#include "JsonReader.h"
+#include "ModelRegistry.h"
+#include "ParameterDescriptors.h"
 #include <algorithm>
 #include <cctype>
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
-#include <regex>
 #include <vector>
 
 #ifdef USE_LLAMA_CPP
@@ -24,12 +27,16 @@ namespace incant {
 namespace {
 #ifdef USE_LLAMA_CPP
 constexpr int kDefaultMaxTokens = 192;
-constexpr int kDefaultContextSize = 2048;
-constexpr int kDefaultBatchSize = 512;
 constexpr int kDefaultGpuLayers = 0;
 
 const char* const kModelEnvVar = "INCANT_LLM_MODEL";
 const char* const kModelDirEnvVar = "INCANT_LLM_MODEL_DIR";
+const char* const kPrefixCacheEnvVar = "INCANT_LLM_PREFIX_CACHE";
+const char* const kPreloadEnvVar = "INCANT_LLM_PRELOAD";
+const char* const kLockMemoryEnvVar = "INCANT_LLM_MLOCK";
+
+// Room for a typical description when the context is sized before any cast
+constexpr int kDescriptionHeadroom = 64;
 const char* const kDefaultModelFilename = "Phi-4-mini-instruct.Q4_K_M.gguf";
 
 std::string toLowerCopy(std::string value) {
@@ -75,53 +82,79 @@ std::filesystem::path getModuleDirectory() {
     return modulePath.parent_path();
 }
 
-std::string formatPrompt(const char* templateStr, const std::string& description) {
-    if (!templateStr) {
-        return description;
-    }
-    int size = std::snprintf(nullptr, 0, templateStr, description.c_str());
-    if (size <= 0) {
-        return description;
+// A prompt split around the description. The head is the same for every
+// cast of an effect and is kept prefilled; only the tail is decoded per cast.
+struct PromptParts {
+    std::string head;
+    std::string tail;
+};
+
+PromptParts splitPrompt(const char* templateStr, const std::string& description, bool phiChat) {
+    PromptParts parts;
+    const std::string text = templateStr ? templateStr : "%s";
+    const auto marker = text.find("%s");
+    if (marker == std::string::npos) {
+        parts.head = text;
+    } else {
+        parts.head = text.substr(0, marker);
+        parts.tail = description + text.substr(marker + 2);
     }
-    std::string result(static_cast<size_t>(size), '\0');
-    std::snprintf(result.data(), result.size() + 1, templateStr, description.c_str());
-    return result;
-}
 
-std::string wrapPhiChatPrompt(const std::string& userPrompt) {
-    static const std::string kSystem = "You are a helpful assistant.";
-    std::string result;
-    result.reserve(userPrompt.size() + kSystem.size() + 64);
-    result.append("<|system|>");
-    result.append(kSystem);
-    result.append("<|end|><|user|>");
-    result.append(userPrompt);
-    result.append("<|end|><|assistant|>");
-    return result;
+    if (phiChat) {
+        static const std::string kSystem = "You are a helpful assistant.";
+        parts.head = "<|system|>" + kSystem + "<|end|><|user|>" + parts.head;
+        parts.tail.append("<|end|><|assistant|>");
+    }
+    return parts;
 }
 
-std::string extractJsonObject(const std::string& text) {
-    auto start = text.find('{');
-    auto end = text.rfind('}');
-    if (start == std::string::npos || end == std::string::npos || end <= start) {
+std::vector<llama_token> tokenize(const llama_vocab* vocab, const std::string& text, bool addSpecial) {
+    const int count = -llama_tokenize(vocab, text.c_str(), static_cast<int32_t>(text.size()),
+        nullptr, 0, addSpecial, true);
+    if (count <= 0) {
         return {};
     }
-    return text.substr(start, end - start + 1);
+    std::vector<llama_token> tokens(static_cast<size_t>(count));
+    if (llama_tokenize(vocab, text.c_str(), static_cast<int32_t>(text.size()),
+            tokens.data(), count, addSpecial, true) < 0) {
+        return {};
+    }
+    return tokens;
 }
 
-bool extractFloat(const std::string& json, const std::string& key, float& value) {
-    std::regex pattern("\"" + key + "\"\\s*:\\s*([-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?)");
-    std::smatch match;
-    if (!std::regex_search(json, match, pattern)) {
-        return false;
-    }
-    try {
-        value = std::stof(match[1].str());
-    } catch (...) {
-        return false;
+// GBNF for one effect's answer: a flat JSON object whose keys come from the
+// effect's table and whose values are numbers in [0, 1]. Keys are optional
+// and unordered, so the model only spends tokens on what the description
+// calls for (the EQ alone has over a hundred).
+template <typename Params>
+std::string buildGrammar() {
+    std::string keys;
+    for (int i = 0; i < numParameters<Params>(); ++i) {
+        if (i > 0) {
+            keys.append(" | ");
+        }
+        keys.append("\"\\\"").append(findParameter<Params>(i)->key).append("\\\"\"");
     }
-    value = std::clamp(value, 0.0f, 1.0f);
-    return true;
+
+    return "root ::= \"{\" ws member (\",\" ws member)* ws \"}\"\n"
+           "member ::= key ws \":\" ws value\n"
+           "key ::= " + keys + "\n"
+           "value ::= \"0\" (\".\" [0-9]{1,3})? | \"1\" (\".\" \"0\"{1,3})?\n"
+           "ws ::= [ \\t\\n]{0,4}\n";
+}
+
+bool isEnvFlagSet(const char* name) {
+    const char* value = std::getenv(name);
+    return value && std::string(value) == "1";
+}
+
+// Prefilled prompt heads are only written to disk when this is set to 1
+bool isPrefixFileEnabled() {
+    return isEnvFlagSet(kPrefixCacheEnvVar);
+}
+
+std::string getPrefixFilePath(const std::string& modelPath, EffectType type) {
+    return modelPath + "." + toLowerCopy(getEffectTypeName(type)) + ".prefix";
 }
 
 std::string findGgufInDirectory(const std::filesystem::path& dir) {
@@ -256,17 +289,28 @@ std::string resolveModelPath(const std::string& preferredPath) {
 
 LLMEngine::LLMEngine() {
 #ifdef USE_LLAMA_CPP
-    llama_backend_init();
-    ggml_backend_load_all();
+    // Initializes the llama.cpp backend on first use
+    ModelRegistry::getInstance();
+    scheduler_ = InferenceScheduler::acquire();
 #endif
+    inferenceThread_ = std::thread([this] { runWorker(); });
 }
 
 LLMEngine::~LLMEngine() {
-    cancelGeneration();
+    shuttingDown_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        stopping_ = true;
+        mailbox_.reset();
+        cancelRequested_ = true;
+    }
+    mailboxChanged_.notify_one();
+
+    inferenceThread_.join();
+    if (preloadThread_.joinable()) {
+        preloadThread_.join();
+    }
     unloadModel();
-#ifdef USE_LLAMA_CPP
-    llama_backend_free();
-#endif
 }
 
 bool LLMEngine::loadModel(const std::string& modelPath) {
@@ -274,35 +318,47 @@ bool LLMEngine::loadModel(const std::string& modelPath) {
     std::lock_guard<std::mutex> lock(modelMutex_);
 
     if (model_) {
-        status_ = Status::Ready;
+        setIdleStatus(Status::Ready);
         return true;
     }
 
     auto resolvedPath = resolveModelPath(modelPath);
     if (resolvedPath.empty()) {
         lastError_ = "No GGUF model found (set INCANT_LLM_MODEL or INCANT_LLM_MODEL_DIR).";
-        status_ = Status::Unloaded;
+        setIdleStatus(Status::Unloaded);
         return false;
     }
 
-    status_ = Status::Loading;
+    loadProgress_ = 0.0f;
+    setIdleStatus(Status::Loading);
 
+    // The GGUF is memory-mapped (llama.cpp's default); locking it keeps the
+    // weights resident between casts at the cost of wired memory
     llama_model_params modelParams = llama_model_default_params();
     modelParams.n_gpu_layers = kDefaultGpuLayers;
+    modelParams.use_mlock = isEnvFlagSet(kLockMemoryEnvVar);
+    modelParams.progress_callback_user_data = this;
+    modelParams.progress_callback = [](float progress, void* userData) {
+        auto* engine = static_cast<LLMEngine*>(userData);
+        engine->loadProgress_ = progress;
+        return !engine->shuttingDown_.load();
+    };
 
-    model_ = llama_model_load_from_file(resolvedPath.c_str(), modelParams);
+    // Shared with every other instance using the same file
+    model_ = ModelRegistry::getInstance().acquire(resolvedPath, modelParams);
     if (!model_) {
         lastError_ = "Failed to load GGUF model: " + resolvedPath;
-        status_ = Status::Error;
+        setIdleStatus(Status::Error);
         return false;
     }
 
-    vocab_ = llama_model_get_vocab(model_);
+    vocab_ = llama_model_get_vocab(model_.get());
     modelPath_ = resolvedPath;
-    status_ = Status::Ready;
+    loadProgress_ = 1.0f;
+    setIdleStatus(Status::Ready);
     return true;
 #else
-    status_ = Status::Ready;
+    setIdleStatus(Status::Ready);
     return true;
 #endif
 }
@@ -311,300 +367,260 @@ void LLMEngine::unloadModel() {
 #ifdef USE_LLAMA_CPP
     std::lock_guard<std::mutex> lock(modelMutex_);
 
-    if (model_) {
-        llama_model_free(model_);
-        model_ = nullptr;
+    headTokens_ = {};
+    for (auto& sampler : samplers_) {
+        if (sampler) {
+            llama_sampler_free(sampler);
+            sampler = nullptr;
+        }
     }
+    // Freed once no other instance holds it
+    scheduler_->release(model_);
     vocab_ = nullptr;
 #endif
     status_ = Status::Unloaded;
 }
 
+void LLMEngine::preloadModel(EffectType effectType) {
+#ifdef USE_LLAMA_CPP
+    if (!isEnvFlagSet(kPreloadEnvVar) || preloadThread_.joinable()) {
+        return;
+    }
+
+    preloadThread_ = std::thread([this, effectType]() {
+        InferenceScheduler::setBackgroundPriority();
+        if (loadModel(modelPath_) && !shuttingDown_) {
+            warmUp(effectType);
+        }
+    });
+#else
+    (void) effectType;
+#endif
+}
+
+void LLMEngine::setIdleStatus(Status status) {
+    // A cast in progress owns the status until it delivers its result
+    auto current = status_.load();
+    while (current != Status::Processing && !status_.compare_exchange_weak(current, status)) {
+    }
+}
+
 void LLMEngine::generateParameters(EffectType effectType,
                                    const std::string& description,
                                    ResultCallback callback) {
-    cancelGeneration();
-
     status_ = Status::Processing;
-    cancelRequested_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        mailbox_ = Cast{effectType, description, std::move(callback)};
+        ++submissions_;
+        // The cast in flight stops at its next decode step
+        cancelRequested_ = true;
+    }
+    mailboxChanged_.notify_one();
+}
 
-    inferenceThread_ = std::thread([this, effectType, description, callback]() {
-        bool usedLLM = false;
-        ParameterResult result = parseKeywords(effectType, description);
+void LLMEngine::runWorker() {
+    std::unique_lock<std::mutex> lock(mailboxMutex_);
+    for (;;) {
+        mailboxChanged_.wait(lock, [this] { return stopping_ || mailbox_.has_value(); });
 
+        std::uint64_t taken = submissions_;
 #ifdef USE_LLAMA_CPP
-        if (!model_) {
-            loadModel(modelPath_);
+        // Debounce: a cast that is replaced within kDebounce never reaches
+        // the model, so quick re-casting only runs the last description.
+        // Each one still gets its keyword preview right away.
+        deliverPreview(lock);
+        while (!stopping_ && mailbox_
+               && mailboxChanged_.wait_for(lock, kDebounce, [this, taken] { return stopping_ || submissions_ != taken; })) {
+            taken = submissions_;
+            deliverPreview(lock);
         }
-
-        llama_model* model = nullptr;
-        const llama_vocab* vocab = nullptr;
-        std::string modelPath;
-        {
-            std::lock_guard<std::mutex> lock(modelMutex_);
-            model = model_;
-            vocab = vocab_;
-            modelPath = modelPath_;
+#endif
+        // Without a model the keyword match is the whole cast, and it goes
+        // out at once
+        if (stopping_) {
+            return;
+        }
+        if (!mailbox_) {
+            // Cancelled before it ran: nothing else will clear Processing
+            status_ = Status::Ready;
+            continue;
         }
 
-        if (model && vocab) {
-            std::string userPrompt = formatPrompt(getPromptTemplate(effectType), description);
-            std::string prompt = userPrompt;
-            if (isPhiMiniModel(modelPath)) {
-                prompt = wrapPhiChatPrompt(userPrompt);
-            }
-
-            const int n_prompt = -llama_tokenize(vocab, prompt.c_str(), prompt.size(),
-                nullptr, 0, true, true);
-            if (n_prompt > 0) {
-                std::vector<llama_token> promptTokens(static_cast<size_t>(n_prompt));
-                if (llama_tokenize(vocab, prompt.c_str(), prompt.size(),
-                        promptTokens.data(), promptTokens.size(), true, true) >= 0) {
-
-                    llama_context_params ctxParams = llama_context_default_params();
-                    ctxParams.n_ctx = std::max(kDefaultContextSize,
-                        n_prompt + kDefaultMaxTokens + 8);
-                    ctxParams.n_batch = std::min(kDefaultBatchSize, n_prompt);
-
-                    llama_context* ctx = llama_init_from_model(model, ctxParams);
-                    if (ctx) {
-                        auto sparams = llama_sampler_chain_default_params();
-                        llama_sampler* sampler = llama_sampler_chain_init(sparams);
-
-                        llama_sampler_chain_add(sampler, llama_sampler_init_top_k(40));
-                        llama_sampler_chain_add(sampler, llama_sampler_init_top_p(0.9f, 1));
-                        llama_sampler_chain_add(sampler, llama_sampler_init_temp(0.2f));
-                        llama_sampler_chain_add(sampler, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
-
-                        llama_batch batch = llama_batch_get_one(promptTokens.data(), promptTokens.size());
-
-                        bool decodeOk = true;
-                        if (llama_model_has_encoder(model)) {
-                            decodeOk = (llama_encode(ctx, batch) == 0);
-                            if (decodeOk) {
-                                llama_token decoderStart = llama_model_decoder_start_token(model);
-                                if (decoderStart == LLAMA_TOKEN_NULL) {
-                                    decoderStart = llama_vocab_bos(vocab);
-                                }
-                                batch = llama_batch_get_one(&decoderStart, 1);
-                            }
-                        }
-
-                        std::string output;
-                        if (decodeOk) {
-                            for (int i = 0; i < kDefaultMaxTokens; ++i) {
-                                if (llama_decode(ctx, batch) != 0) {
-                                    break;
-                                }
-                                llama_token token = llama_sampler_sample(sampler, ctx, -1);
-                                if (llama_vocab_is_eog(vocab, token)) {
-                                    break;
-                                }
-
-                                char buf[256];
-                                int n = llama_token_to_piece(vocab, token, buf, sizeof(buf), 0, true);
-                                if (n > 0) {
-                                    output.append(buf, static_cast<size_t>(n));
-                                }
-
-                                if (cancelRequested_) {
-                                    break;
-                                }
-
-                                batch = llama_batch_get_one(&token, 1);
-                            }
-                        }
-
-                        llama_sampler_free(sampler);
-                        llama_free(ctx);
-
-                        std::string json = extractJsonObject(output);
-                        if (!json.empty()) {
-                            usedLLM = true;
-                            switch (effectType) {
-                                case EffectType::EQ: {
-                                    EQParams params = std::get<EQParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "lowGain", params.lowGain);
-                                    any |= extractFloat(json, "midGain", params.midGain);
-                                    any |= extractFloat(json, "highGain", params.highGain);
-                                    any |= extractFloat(json, "airGain", params.airGain);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Compressor: {
-                                    CompressorParams params = std::get<CompressorParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "threshold", params.threshold);
-                                    any |= extractFloat(json, "ratio", params.ratio);
-                                    any |= extractFloat(json, "attack", params.attack);
-                                    any |= extractFloat(json, "release", params.release);
-                                    any |= extractFloat(json, "makeup", params.makeup);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Reverb: {
-                                    ReverbParams params = std::get<ReverbParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "size", params.size);
-                                    any |= extractFloat(json, "decay", params.decay);
-                                    any |= extractFloat(json, "damping", params.damping);
-                                    any |= extractFloat(json, "predelay", params.predelay);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Distortion: {
-                                    DistortionParams params = std::get<DistortionParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "drive", params.drive);
-                                    any |= extractFloat(json, "tone", params.tone);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    any |= extractFloat(json, "curveType", params.curveType);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Delay: {
-                                    DelayParams params = std::get<DelayParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "time", params.time);
-                                    any |= extractFloat(json, "feedback", params.feedback);
-                                    any |= extractFloat(json, "filter", params.filter);
-                                    any |= extractFloat(json, "pingPong", params.pingPong);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Glitch: {
-                                    GlitchParams params = std::get<GlitchParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "rate", params.rate);
-                                    any |= extractFloat(json, "stutter", params.stutter);
-                                    any |= extractFloat(json, "crush", params.crush);
-                                    any |= extractFloat(json, "reverse", params.reverse);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Overdrive: {
-                                    OverdriveParams params = std::get<OverdriveParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "drive", params.drive);
-                                    any |= extractFloat(json, "tone", params.tone);
-                                    any |= extractFloat(json, "level", params.level);
-                                    any |= extractFloat(json, "midBoost", params.midBoost);
-                                    any |= extractFloat(json, "tightness", params.tightness);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Chorus: {
-                                    ChorusParams params = std::get<ChorusParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "rate", params.rate);
-                                    any |= extractFloat(json, "depth", params.depth);
-                                    any |= extractFloat(json, "delay", params.delay);
-                                    any |= extractFloat(json, "feedback", params.feedback);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Phaser: {
-                                    PhaserParams params = std::get<PhaserParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "rate", params.rate);
-                                    any |= extractFloat(json, "depth", params.depth);
-                                    any |= extractFloat(json, "feedback", params.feedback);
-                                    any |= extractFloat(json, "stages", params.stages);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Tremolo: {
-                                    TremoloParams params = std::get<TremoloParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "rate", params.rate);
-                                    any |= extractFloat(json, "depth", params.depth);
-                                    any |= extractFloat(json, "shape", params.shape);
-                                    any |= extractFloat(json, "stereo", params.stereo);
-                                    any |= extractFloat(json, "dryWet", params.dryWet);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                                case EffectType::Filter: {
-                                    FilterParams params = std::get<FilterParams>(getDefaultParams(effectType));
-                                    bool any = false;
-                                    any |= extractFloat(json, "cutoff", params.cutoff);
-                                    any |= extractFloat(json, "resonance", params.resonance);
-                                    any |= extractFloat(json, "lfoRate", params.lfoRate);
-                                    any |= extractFloat(json, "lfoDepth", params.lfoDepth);
-                                    any |= extractFloat(json, "filterType", params.filterType);
-                                    if (any) {
-                                        result = params;
-                                    } else {
-                                        usedLLM = false;
-                                    }
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
+        Cast cast = std::move(*mailbox_);
+        mailbox_.reset();
+        cancelRequested_ = false;
+        lock.unlock();
+
+        bool usedLLM = false;
+        ParameterResult result = parseKeywords(cast.effectType, cast.description);
+
+#ifdef USE_LLAMA_CPP
+        // Waits for a preload in progress rather than loading twice
+        loadModel(modelPath_);
+        usedLLM = runModel(cast.effectType, cast.description, result);
+#endif
+
+        lock.lock();
+        if (submissions_ != taken) {
+            // Superseded or cancelled while running: its result is stale
+            if (!mailbox_) {
+                status_ = Status::Ready;
             }
+            continue;
         }
-#endif
 
         status_ = Status::Ready;
-        callback(usedLLM, result);
-    });
+        lock.unlock();
+        cast.callback(usedLLM, false, result);
+        lock.lock();
+    }
 }
 
-void LLMEngine::cancelGeneration() {
-    cancelRequested_ = true;
+#ifdef USE_LLAMA_CPP
+void LLMEngine::deliverPreview(std::unique_lock<std::mutex>& lock) {
+    if (stopping_ || !mailbox_) {
+        return;
+    }
+
+    // Keyword matching takes microseconds, so the sound moves in the next
+    // block; the model's answer replaces it through the effects' smoothing
+    const auto effectType = mailbox_->effectType;
+    const auto description = mailbox_->description;
+    const auto callback = mailbox_->callback;
+    const auto taken = submissions_;
+    lock.unlock();
+
+    const auto result = parseKeywords(effectType, description);
+
+    lock.lock();
+    if (submissions_ != taken) {
+        return;
+    }
+    lock.unlock();
+    callback(false, true, result);
+    lock.lock();
+}
+#endif
+
+#ifdef USE_LLAMA_CPP
+bool LLMEngine::runModel(EffectType effectType, const std::string& description, ParameterResult& result) {
+    // Held for the whole cast so the model and sampler can't be unloaded under us
+    std::lock_guard<std::mutex> lock(modelMutex_);
+    if (!model_ || !vocab_) {
+        return false;
+    }
+
+    const auto parts = splitPrompt(getPromptTemplate(effectType), description, isPhiMiniModel(modelPath_));
+    auto& head = headTokens_[static_cast<size_t>(effectType)];
+    if (head.empty()) {
+        head = tokenize(vocab_, parts.head, true);
+    }
+    auto tail = tokenize(vocab_, parts.tail, false);
+    llama_sampler* sampler = getSampler(effectType);
+    if (head.empty() || tail.empty() || !sampler) {
+        return false;
+    }
+
+    InferenceScheduler::Request request;
+    request.model = model_;
+    request.head = head;
+    request.tail = std::move(tail);
+    request.headKey = static_cast<int>(effectType);
+    if (isPrefixFileEnabled()) {
+        request.headFile = getPrefixFilePath(modelPath_, effectType);
+    }
+    request.sampler = sampler;
+    request.maxTokens = kDefaultMaxTokens;
+    request.contextTokens = static_cast<int>(request.head.size() + request.tail.size()) + kDefaultMaxTokens + 8;
+    // The grammar ends the answer at the object's closing brace
+    request.stopCharacter = '}';
+    request.priority = focused_ ? InferenceScheduler::Priority::Focused : InferenceScheduler::Priority::Normal;
+    request.cancel = &cancelRequested_;
+
+    // Decoded together with whatever other instances are casting
+    const std::string output = scheduler_->submit(std::move(request)).get();
+
+    // Refines the keyword preview: keys the model leaves out keep the value
+    // the preview already applied instead of snapping back to a default
+    ParameterResult parsed = result;
+    const bool any = std::visit([&output](auto& params) {
+        return readJsonObject(output, params).any();
+    }, parsed);
+
+    if (any) {
+        result = parsed;
+    }
+    return any;
+}
+
+llama_sampler* LLMEngine::getSampler(EffectType type) {
+    auto& sampler = samplers_[static_cast<size_t>(type)];
+    if (sampler) {
+        // Rewinds the grammar to the start of the object
+        llama_sampler_reset(sampler);
+        return sampler;
+    }
+
+    sampler = llama_sampler_chain_init(llama_sampler_chain_default_params());
+
+    // Without a grammar (e.g. it failed to parse) the answer is still
+    // parsed leniently, it just isn't guaranteed to be valid
+    const auto grammar = std::visit([](const auto& params) {
+        return buildGrammar<std::decay_t<decltype(params)>>();
+    }, getDefaultParams(type));
+    if (auto* constrained = llama_sampler_init_grammar(vocab_, grammar.c_str(), "root")) {
+        llama_sampler_chain_add(sampler, constrained);
+    }
+
+    llama_sampler_chain_add(sampler, llama_sampler_init_top_k(40));
+    llama_sampler_chain_add(sampler, llama_sampler_init_top_p(0.9f, 1));
+    llama_sampler_chain_add(sampler, llama_sampler_init_temp(0.2f));
+    llama_sampler_chain_add(sampler, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+    return sampler;
+}
+
+bool LLMEngine::warmUp(EffectType type) {
+    std::lock_guard<std::mutex> lock(modelMutex_);
+    if (!model_ || !vocab_) {
+        return false;
+    }
+
+    // Prefilling the effect's prompt head is the warm-up decode: it pages the
+    // weights in and leaves the head cached for the first cast
+    auto& head = headTokens_[static_cast<size_t>(type)];
+    if (head.empty()) {
+        const auto parts = splitPrompt(getPromptTemplate(type), {}, isPhiMiniModel(modelPath_));
+        head = tokenize(vocab_, parts.head, true);
+    }
+    if (head.empty() || !getSampler(type)) {
+        return false;
+    }
 
-    if (inferenceThread_.joinable()) {
-        inferenceThread_.join();
+    InferenceScheduler::Request request;
+    request.model = model_;
+    request.head = head;
+    request.headKey = static_cast<int>(type);
+    if (isPrefixFileEnabled()) {
+        request.headFile = getPrefixFilePath(modelPath_, type);
     }
+    request.contextTokens = static_cast<int>(head.size()) + kDescriptionHeadroom + kDefaultMaxTokens + 8;
+    request.priority = InferenceScheduler::Priority::Background;
+    request.cancel = &shuttingDown_;
+
+    scheduler_->submit(std::move(request)).wait();
+    return true;
+}
+#endif
+
+void LLMEngine::cancelGeneration() {
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        mailbox_.reset();
+        ++submissions_;
+        cancelRequested_ = true;
+    }
+    mailboxChanged_.notify_one();
 }
 
 std::string LLMEngine::getLastError() const {
@@ -651,50 +667,79 @@ ParameterResult LLMEngine::parseKeywords(EffectType type, const std::string& des
 
             // Low frequencies
             if (containsAny({"bass", "low", "sub", "boom", "thump", "weight", "bottom"})) {
-                params.lowGain = 0.7f;
+                params.bands[EQParams::Low].gain = 0.7f;
             }
             if (containsAny({"warm", "full", "thick", "fat"})) {
-                params.lowGain = 0.65f;
-                params.midGain = 0.55f;
+                params.bands[EQParams::Low].gain = 0.65f;
+                params.bands[EQParams::Mid].gain = 0.55f;
             }
             if (containsAny({"thin", "tinny", "hollow", "weak"})) {
-                params.lowGain = 0.35f;
+                params.bands[EQParams::Low].gain = 0.35f;
             }
 
             // Mid frequencies
             if (containsAny({"mid", "presence", "vocal", "punch", "body"})) {
-                params.midGain = 0.65f;
+                params.bands[EQParams::Mid].gain = 0.65f;
             }
             if (containsAny({"nasal", "honky", "boxy"})) {
-                params.midGain = 0.7f;
+                params.bands[EQParams::Mid].gain = 0.7f;
             }
             if (containsAny({"scooped", "smile", "v-curve"})) {
-                params.midGain = 0.3f;
-                params.lowGain = 0.65f;
-                params.highGain = 0.65f;
+                params.bands[EQParams::Mid].gain = 0.3f;
+                params.bands[EQParams::Low].gain = 0.65f;
+                params.bands[EQParams::High].gain = 0.65f;
             }
 
             // High frequencies
             if (containsAny({"bright", "crisp", "sharp", "treble", "clear", "definition"})) {
-                params.highGain = 0.7f;
+                params.bands[EQParams::High].gain = 0.7f;
             }
             if (containsAny({"dark", "muffled", "dull", "muted", "smooth"})) {
-                params.highGain = 0.3f;
-                params.airGain = 0.3f;
+                params.bands[EQParams::High].gain = 0.3f;
+                params.bands[EQParams::Air].gain = 0.3f;
             }
 
             // Air/sparkle
             if (containsAny({"air", "shimmer", "sparkle", "airy", "open", "ethereal"})) {
-                params.airGain = 0.75f;
+                params.bands[EQParams::Air].gain = 0.75f;
             }
             if (containsAny({"digital", "hi-fi", "modern", "crystal"})) {
-                params.highGain = 0.7f;
-                params.airGain = 0.7f;
+                params.bands[EQParams::High].gain = 0.7f;
+                params.bands[EQParams::Air].gain = 0.7f;
             }
             if (containsAny({"analog", "vintage", "retro", "lo-fi"})) {
-                params.highGain = 0.4f;
-                params.airGain = 0.35f;
-                params.lowGain = 0.6f;
+                params.bands[EQParams::High].gain = 0.4f;
+                params.bands[EQParams::Air].gain = 0.35f;
+                params.bands[EQParams::Low].gain = 0.6f;
+            }
+
+            // Phase-transparent processing
+            if (containsAny({"linear phase", "linear-phase", "mastering", "phase coherent"})) {
+                params.linearPhase = 1.0f;
+            }
+
+            // Extra bands for targeted fixes
+            if (containsAny({"de-ess", "deess", "sibilance", "sibilant"})) {
+                auto& band = params.bands[4];
+                band.enabled = 1.0f;
+                band.frequency = 0.86f;   // ~7kHz
+                band.q = 0.6f;
+                band.gain = 0.25f;
+                band.dynamic = 1.0f;
+                band.threshold = 0.45f;
+            }
+            if (containsAny({"rumble", "low cut", "high-pass", "highpass"})) {
+                auto& band = params.bands[5];
+                band.enabled = 1.0f;
+                band.type = 0.6f;         // Low cut
+                band.frequency = 0.18f;   // ~70Hz
+            }
+            if (containsAny({"hum", "buzz"})) {
+                auto& band = params.bands[6];
+                band.enabled = 1.0f;
+                band.type = 1.0f;         // Notch
+                band.frequency = 0.15f;   // ~55Hz
+                band.q = 0.85f;
             }
 
             return params;
@@ -713,6 +758,7 @@ ParameterResult LLMEngine::parseKeywords(EffectType type, const std::string& des
                 params.threshold = 0.65f;
                 params.ratio = 0.15f;
                 params.makeup = 0.3f;
+                params.knee = 0.5f;
             }
 
             // Character
@@ -726,11 +772,15 @@ ParameterResult LLMEngine::parseKeywords(EffectType type, const std::string& des
                 params.release = 0.6f;
                 params.ratio = 0.2f;
                 params.threshold = 0.55f;
+                params.detector = 1.0f;
+                params.link = 1.0f;
             }
             if (containsAny({"limiting", "brick", "loud", "maximized"})) {
                 params.ratio = 1.0f;
                 params.threshold = 0.3f;
                 params.attack = 0.05f;
+                params.lookahead = 0.5f;
+                params.link = 1.0f;
             }
             if (containsAny({"slow", "breathing", "relaxed"})) {
                 params.attack = 0.7f;
@@ -752,6 +802,35 @@ ParameterResult LLMEngine::parseKeywords(EffectType type, const std::string& des
                 params.ratio = 0.5f;
             }
 
+            // External key
+            if (containsAny({"sidechain", "duck", "ducking", "keyed"})) {
+                params.sidechain = 1.0f;
+                params.link = 1.0f;
+            }
+
+            // Multiband: split into low / low-mid / high-mid / high
+            if (containsAny({"multiband", "multi-band", "mastering", "master"})) {
+                params.multiband = 1.0f;
+                params.link = 1.0f;
+                for (auto& band : params.bands) {
+                    band.threshold = params.threshold;
+                    band.ratio = params.ratio;
+                }
+            }
+            if (containsAny({"boomy", "muddy", "bass", "low end"})) {
+                params.multiband = 1.0f;
+                params.bands[0].threshold = 0.35f;
+                params.bands[0].ratio = 0.35f;
+                params.bands[1].threshold = 0.45f;
+            }
+            if (containsAny({"harsh", "sibilant", "de-ess", "deess", "bright"})) {
+                params.multiband = 1.0f;
+                params.crossoverHigh = 0.6f;
+                params.bands[3].threshold = 0.35f;
+                params.bands[3].ratio = 0.45f;
+                params.attack = std::min(params.attack, 0.1f);
+            }
+
             return params;
         }
 
@@ -1278,6 +1357,17 @@ ParameterResult LLMEngine::parseKeywords(EffectType type, const std::string& des
                 params.lfoDepth = 0.7f;
             }
 
+            // Envelope follower
+            if (containsAny({"envelope", "auto-wah", "autowah", "touch", "dynamic"})) {
+                params.envDepth = 0.6f;
+                params.lfoDepth = 0.0f;
+            }
+            if (containsAny({"sidechain", "keyed", "ducking", "duck"})) {
+                params.envDepth = 0.7f;
+                params.envSource = 1.0f;
+                params.lfoDepth = 0.0f;
+            }
+
             return params;
         }
     }
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "ParameterSchema.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <string>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <variant>
+#include <vector>
 
 // Uncomment to enable llama.cpp integration (requires stable API)
 // #define USE_LLAMA_CPP
@@ -14,10 +21,15 @@
 #ifdef USE_LLAMA_CPP
 struct llama_model;
 struct llama_vocab;
+struct llama_sampler;
 #endif
 
 namespace incant {
 
+#ifdef USE_LLAMA_CPP
+class InferenceScheduler;
+#endif
+
 using ParameterResult = std::variant<EQParams, CompressorParams, ReverbParams, DistortionParams,
     DelayParams, GlitchParams, OverdriveParams, ChorusParams, PhaserParams, TremoloParams, FilterParams>;
 
@@ -31,7 +43,9 @@ public:
         Error
     };
 
-    using ResultCallback = std::function<void(bool success, const ParameterResult& result)>;
+    // success: the model produced the result. provisional: a keyword match
+    // delivered straight away, to be followed by the model's result.
+    using ResultCallback = std::function<void(bool success, bool provisional, const ParameterResult& result)>;
 
     LLMEngine();
     ~LLMEngine();
@@ -40,15 +54,30 @@ public:
     bool loadModel(const std::string& modelPath);
     void unloadModel();
 
-    // Async parameter generation
+    // Opt-in (INCANT_LLM_PRELOAD=1): loads the model on a low-priority thread
+    // and prefills the given effect's prompt, so the first cast doesn't stall.
+    // Progress shows up as Status::Loading and getLoadProgress().
+    void preloadModel(EffectType effectType);
+
+    // Async parameter generation; returns immediately. Only the latest
+    // request is kept: a newer one replaces a pending request and stops a
+    // running one, whose callback is then never called. With a model the
+    // callback runs twice: first with the keyword match, flagged
+    // provisional, as soon as the worker sees the request, then with the
+    // model's answer.
     void generateParameters(EffectType effectType,
                            const std::string& description,
                            ResultCallback callback);
 
-    // Cancel pending generation
+    // Drops the pending request and stops the running one, without waiting
     void cancelGeneration();
 
     Status getStatus() const { return status_.load(); }
+    float getLoadProgress() const { return loadProgress_.load(); }
+
+    // Casts from an instance whose editor has focus are decoded first
+    // when several instances cast at once
+    void setFocused(bool focused) { focused_.store(focused); }
     std::string getLastError() const;
 
     // Keyword-based parameter generation (primary method)
@@ -56,15 +85,54 @@ public:
     static ParameterResult parseKeywords(EffectType type, const std::string& description);
 
 private:
+    // How long a request must stay unreplaced before it starts
+    static constexpr std::chrono::milliseconds kDebounce{100};
+
+    struct Cast {
+        EffectType effectType;
+        std::string description;
+        ResultCallback callback;
+    };
+
+    void runWorker();
+    void setIdleStatus(Status status);
+
 #ifdef USE_LLAMA_CPP
-    llama_model* model_ = nullptr;
+    // Worker thread, mailbox locked: sends the pending cast's keyword match
+    void deliverPreview(std::unique_lock<std::mutex>& lock);
+
+    // Worker threads; they take modelMutex_ themselves
+    bool runModel(EffectType effectType, const std::string& description, ParameterResult& result);
+    bool warmUp(EffectType type);
+    llama_sampler* getSampler(EffectType type);
+
+    std::shared_ptr<InferenceScheduler> scheduler_;    // shared by every instance
+    std::shared_ptr<llama_model> model_;    // from ModelRegistry
     const llama_vocab* vocab_ = nullptr;
+
+    // Tokens of each effect's prompt head (everything before the
+    // description); InferenceScheduler keeps it prefilled
+    std::array<std::vector<int32_t>, kNumEffectTypes> headTokens_;
+
+    // Per effect, constrained to that effect's JSON object; built on first use
+    std::array<llama_sampler*, kNumEffectTypes> samplers_{};
 #endif
 
     std::atomic<Status> status_{Status::Unloaded};
     std::atomic<bool> cancelRequested_{false};
-
-    std::thread inferenceThread_;
+    std::atomic<bool> shuttingDown_{false};
+    std::atomic<float> loadProgress_{0.0f};
+    std::atomic<bool> focused_{false};
+
+    // Latest-wins mailbox for the worker
+    std::mutex mailboxMutex_;
+    std::condition_variable mailboxChanged_;
+    std::optional<Cast> mailbox_;
+    std::uint64_t submissions_ = 0;     // bumped by every request and cancel
+    bool stopping_ = false;
+
+    std::thread inferenceThread_;       // runs every request, lives as long as the engine
+    std::thread preloadThread_;
     std::mutex modelMutex_;
     std::string lastError_;
     std::string modelPath_;
@@ -0,0 +1,54 @@
+#include "ModelRegistry.h"
+
+#ifdef USE_LLAMA_CPP
+
+#include "llama.h"
+#include <filesystem>
+
+namespace incant {
+
+ModelRegistry& ModelRegistry::getInstance() {
+    static ModelRegistry instance;
+    return instance;
+}
+
+ModelRegistry::ModelRegistry() {
+    llama_backend_init();
+    ggml_backend_load_all();
+}
+
+ModelRegistry::~ModelRegistry() {
+    llama_backend_free();
+}
+
+std::shared_ptr<llama_model> ModelRegistry::acquire(const std::string& path, const llama_model_params& params) {
+    // Different spellings of the same file share one model
+    std::error_code ec;
+    auto key = std::filesystem::weakly_canonical(path, ec).string();
+    if (ec || key.empty()) {
+        key = path;
+    }
+
+    // Held while loading, so a second instance waits for the first load
+    // instead of starting its own
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto& entry = models_[key];
+    if (auto model = entry.lock()) {
+        return model;
+    }
+
+    llama_model* loaded = llama_model_load_from_file(path.c_str(), params);
+    if (!loaded) {
+        models_.erase(key);
+        return {};
+    }
+
+    std::shared_ptr<llama_model> model(loaded, [](llama_model* m) { llama_model_free(m); });
+    entry = model;
+    return model;
+}
+
+} // namespace incant
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef USE_LLAMA_CPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct llama_model;
+struct llama_model_params;
+
+namespace incant {
+
+// One llama_model per GGUF file for the whole process.
+//
+// Every plugin instance asks the registry for its model instead of loading
+// its own copy, so ten instances share one set of weights. Handles are
+// reference counted: the model is freed when the last instance lets go.
+// The registry also owns llama.cpp's backend, initialized once.
+class ModelRegistry {
+public:
+    static ModelRegistry& getInstance();
+
+    // Any thread. Returns the model already loaded from this file, or loads
+    // it with the given parameters; empty if loading failed. Loads of the
+    // same file are never run twice at once.
+    std::shared_ptr<llama_model> acquire(const std::string& path, const llama_model_params& params);
+
+private:
+    ModelRegistry();
+    ~ModelRegistry();
+
+    std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<llama_model>> models_;   // by canonical path
+};
+
+} // namespace incant
+
+#endif
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "ParameterSchema.h"
+#include <array>
+#include <cstddef>
+
+namespace incant {
+
+// Skew value marking an exponential range (frequencies, Q): the normalized
+// value moves through octaves rather than Hz
+constexpr float kLogarithmic = 0.0f;
+
+// One normalized (0-1) float in an effect's params struct.
+//
+// The tables below are the single description of every effect's parameters:
+// the array position is the effect's parameter index, and the effects,
+// host automation, presets and the LLM parser all go through them instead of
+// keeping their own lists of names, keys and fields.
+struct ParameterDescriptor {
+    const char* name;       // shown to users (knobs, host automation lanes)
+    const char* key;        // JSON key in LLM output
+    std::size_t offset;     // byte offset of the float in the params struct
+    float minValue;         // physical range of 0..1
+    float maxValue;
+    float skew;             // 1 = linear, JUCE-style skew otherwise, or kLogarithmic
+    const char* unit;
+};
+
+template <typename Params>
+struct ParameterTable;
+
+namespace detail {
+
+constexpr std::size_t eqBandOffset(int band, std::size_t field) {
+    return offsetof(EQParams, bands) + static_cast<std::size_t>(band) * sizeof(EQBandParams) + field;
+}
+
+constexpr std::size_t compressorBandOffset(int band, std::size_t field) {
+    return offsetof(CompressorParams, bands) + static_cast<std::size_t>(band) * sizeof(CompressorBandParams) + field;
+}
+
+} // namespace detail
+
+#define INCANT_PARAM(Params, field, name, minValue, maxValue, skew, unit) \
+    ParameterDescriptor{name, #field, offsetof(Params, field), minValue, maxValue, skew, unit}
+
+// Layout: 0-3 gains of bands 1-4, 4 dry/wet, 5-16 gains of bands 5-16,
+// 17+ six per band (see Equalizer), then the linear-phase switch
+#define INCANT_EQ_GAIN(n, name, key) \
+    ParameterDescriptor{name, key, detail::eqBandOffset(n - 1, offsetof(EQBandParams, gain)), \
+                        -12.0f, 12.0f, 1.0f, "dB"}
+#define INCANT_EQ_BAND(n) \
+    ParameterDescriptor{"Band " #n " On", "band" #n "Enabled", \
+                        detail::eqBandOffset(n - 1, offsetof(EQBandParams, enabled)), 0.0f, 1.0f, 1.0f, ""}, \
+    ParameterDescriptor{"Band " #n " Type", "band" #n "Type", \
+                        detail::eqBandOffset(n - 1, offsetof(EQBandParams, type)), 0.0f, 1.0f, 1.0f, ""}, \
+    ParameterDescriptor{"Band " #n " Freq", "band" #n "Freq", \
+                        detail::eqBandOffset(n - 1, offsetof(EQBandParams, frequency)), 20.0f, 20000.0f, kLogarithmic, "Hz"}, \
+    ParameterDescriptor{"Band " #n " Q", "band" #n "Q", \
+                        detail::eqBandOffset(n - 1, offsetof(EQBandParams, q)), 0.1f, 10.0f, kLogarithmic, ""}, \
+    ParameterDescriptor{"Band " #n " Dynamic", "band" #n "Dynamic", \
+                        detail::eqBandOffset(n - 1, offsetof(EQBandParams, dynamic)), 0.0f, 100.0f, 1.0f, "%"}, \
+    ParameterDescriptor{"Band " #n " Threshold", "band" #n "Threshold", \
+                        detail::eqBandOffset(n - 1, offsetof(EQBandParams, threshold)), -60.0f, 0.0f, 1.0f, "dB"}
+
+template <>
+struct ParameterTable<EQParams> {
+    static constexpr EffectType type = EffectType::EQ;
+    static constexpr std::array<ParameterDescriptor, 114> parameters{{
+        INCANT_EQ_GAIN(1, "Low", "lowGain"),
+        INCANT_EQ_GAIN(2, "Mid", "midGain"),
+        INCANT_EQ_GAIN(3, "High", "highGain"),
+        INCANT_EQ_GAIN(4, "Air", "airGain"),
+        INCANT_PARAM(EQParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_EQ_GAIN(5, "Band 5 Gain", "band5Gain"),
+        INCANT_EQ_GAIN(6, "Band 6 Gain", "band6Gain"),
+        INCANT_EQ_GAIN(7, "Band 7 Gain", "band7Gain"),
+        INCANT_EQ_GAIN(8, "Band 8 Gain", "band8Gain"),
+        INCANT_EQ_GAIN(9, "Band 9 Gain", "band9Gain"),
+        INCANT_EQ_GAIN(10, "Band 10 Gain", "band10Gain"),
+        INCANT_EQ_GAIN(11, "Band 11 Gain", "band11Gain"),
+        INCANT_EQ_GAIN(12, "Band 12 Gain", "band12Gain"),
+        INCANT_EQ_GAIN(13, "Band 13 Gain", "band13Gain"),
+        INCANT_EQ_GAIN(14, "Band 14 Gain", "band14Gain"),
+        INCANT_EQ_GAIN(15, "Band 15 Gain", "band15Gain"),
+        INCANT_EQ_GAIN(16, "Band 16 Gain", "band16Gain"),
+        INCANT_EQ_BAND(1),
+        INCANT_EQ_BAND(2),
+        INCANT_EQ_BAND(3),
+        INCANT_EQ_BAND(4),
+        INCANT_EQ_BAND(5),
+        INCANT_EQ_BAND(6),
+        INCANT_EQ_BAND(7),
+        INCANT_EQ_BAND(8),
+        INCANT_EQ_BAND(9),
+        INCANT_EQ_BAND(10),
+        INCANT_EQ_BAND(11),
+        INCANT_EQ_BAND(12),
+        INCANT_EQ_BAND(13),
+        INCANT_EQ_BAND(14),
+        INCANT_EQ_BAND(15),
+        INCANT_EQ_BAND(16),
+        INCANT_PARAM(EQParams, linearPhase, "Linear Phase", 0.0f, 1.0f, 1.0f, ""),
+    }};
+};
+
+#undef INCANT_EQ_GAIN
+#undef INCANT_EQ_BAND
+
+#define INCANT_COMPRESSOR_BAND(n, label) \
+    ParameterDescriptor{label " Thresh", "band" #n "Threshold", \
+                        detail::compressorBandOffset(n - 1, offsetof(CompressorBandParams, threshold)), \
+                        -60.0f, 0.0f, 1.0f, "dB"}, \
+    ParameterDescriptor{label " Ratio", "band" #n "Ratio", \
+                        detail::compressorBandOffset(n - 1, offsetof(CompressorBandParams, ratio)), \
+                        1.0f, 20.0f, 1.0f, ":1"}, \
+    ParameterDescriptor{label " Gain", "band" #n "Gain", \
+                        detail::compressorBandOffset(n - 1, offsetof(CompressorBandParams, gain)), \
+                        -12.0f, 12.0f, 1.0f, "dB"}
+
+template <>
+struct ParameterTable<CompressorParams> {
+    static constexpr EffectType type = EffectType::Compressor;
+    static constexpr std::array<ParameterDescriptor, 26> parameters{{
+        INCANT_PARAM(CompressorParams, threshold, "Threshold", -60.0f, 0.0f, 1.0f, "dB"),
+        INCANT_PARAM(CompressorParams, ratio, "Ratio", 1.0f, 20.0f, 1.0f, ":1"),
+        INCANT_PARAM(CompressorParams, attack, "Attack", 0.1f, 100.0f, 1.0f, "ms"),
+        INCANT_PARAM(CompressorParams, release, "Release", 10.0f, 1000.0f, 1.0f, "ms"),
+        INCANT_PARAM(CompressorParams, makeup, "Makeup", 0.0f, 24.0f, 1.0f, "dB"),
+        INCANT_PARAM(CompressorParams, knee, "Knee", 0.0f, 24.0f, 1.0f, "dB"),
+        INCANT_PARAM(CompressorParams, lookahead, "Lookahead", 0.0f, 10.0f, 1.0f, "ms"),
+        INCANT_PARAM(CompressorParams, detector, "Detector", 0.0f, 1.0f, 1.0f, ""),
+        INCANT_PARAM(CompressorParams, link, "Link", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(CompressorParams, multiband, "Multiband", 0.0f, 1.0f, 1.0f, ""),
+        INCANT_PARAM(CompressorParams, crossoverLow, "Low X-Over", 40.0f, 400.0f, kLogarithmic, "Hz"),
+        INCANT_PARAM(CompressorParams, crossoverMid, "Mid X-Over", 200.0f, 2000.0f, kLogarithmic, "Hz"),
+        INCANT_PARAM(CompressorParams, crossoverHigh, "High X-Over", 2000.0f, 16000.0f, kLogarithmic, "Hz"),
+        INCANT_COMPRESSOR_BAND(1, "Low"),
+        INCANT_COMPRESSOR_BAND(2, "Low-Mid"),
+        INCANT_COMPRESSOR_BAND(3, "High-Mid"),
+        INCANT_COMPRESSOR_BAND(4, "High"),
+        INCANT_PARAM(CompressorParams, sidechain, "Sidechain", 0.0f, 1.0f, 1.0f, ""),
+    }};
+};
+
+#undef INCANT_COMPRESSOR_BAND
+
+template <>
+struct ParameterTable<ReverbParams> {
+    static constexpr EffectType type = EffectType::Reverb;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(ReverbParams, size, "Size", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(ReverbParams, decay, "Decay", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(ReverbParams, damping, "Damping", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(ReverbParams, predelay, "PreDelay", 0.0f, 200.0f, 1.0f, "ms"),
+        INCANT_PARAM(ReverbParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+    }};
+};
+
+template <>
+struct ParameterTable<DistortionParams> {
+    static constexpr EffectType type = EffectType::Distortion;
+    static constexpr std::array<ParameterDescriptor, 4> parameters{{
+        INCANT_PARAM(DistortionParams, drive, "Drive", 1.0f, 50.0f, 1.0f, "x"),
+        INCANT_PARAM(DistortionParams, tone, "Tone", 1000.0f, 12000.0f, 1.0f, "Hz"),
+        INCANT_PARAM(DistortionParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(DistortionParams, curveType, "Type", 0.0f, 1.0f, 1.0f, ""),
+    }};
+};
+
+template <>
+struct ParameterTable<DelayParams> {
+    static constexpr EffectType type = EffectType::Delay;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(DelayParams, time, "Time", 10.0f, 1000.0f, 1.0f, "ms"),
+        INCANT_PARAM(DelayParams, feedback, "Feedback", 0.0f, 95.0f, 1.0f, "%"),
+        INCANT_PARAM(DelayParams, filter, "Filter", 500.0f, 15000.0f, 1.0f, "Hz"),
+        INCANT_PARAM(DelayParams, pingPong, "PingPong", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(DelayParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+    }};
+};
+
+template <>
+struct ParameterTable<GlitchParams> {
+    static constexpr EffectType type = EffectType::Glitch;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(GlitchParams, rate, "Rate", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(GlitchParams, stutter, "Stutter", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(GlitchParams, crush, "Crush", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(GlitchParams, reverse, "Reverse", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(GlitchParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+    }};
+};
+
+template <>
+struct ParameterTable<OverdriveParams> {
+    static constexpr EffectType type = EffectType::Overdrive;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(OverdriveParams, drive, "Drive", 1.0f, 100.0f, 1.0f, "x"),
+        INCANT_PARAM(OverdriveParams, tone, "Tone", 1000.0f, 8000.0f, 1.0f, "Hz"),
+        INCANT_PARAM(OverdriveParams, level, "Level", 0.1f, 2.0f, 1.0f, "x"),
+        INCANT_PARAM(OverdriveParams, midBoost, "MidBoost", 0.0f, 12.0f, 1.0f, "dB"),
+        INCANT_PARAM(OverdriveParams, tightness, "Tightness", 60.0f, 720.0f, 1.0f, "Hz"),
+    }};
+};
+
+template <>
+struct ParameterTable<ChorusParams> {
+    static constexpr EffectType type = EffectType::Chorus;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(ChorusParams, rate, "Rate", 0.1f, 5.0f, 1.0f, "Hz"),
+        INCANT_PARAM(ChorusParams, depth, "Depth", 0.5f, 5.0f, 1.0f, "ms"),
+        INCANT_PARAM(ChorusParams, delay, "Delay", 5.0f, 30.0f, 1.0f, "ms"),
+        INCANT_PARAM(ChorusParams, feedback, "Feedback", 0.0f, 70.0f, 1.0f, "%"),
+        INCANT_PARAM(ChorusParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+    }};
+};
+
+template <>
+struct ParameterTable<PhaserParams> {
+    static constexpr EffectType type = EffectType::Phaser;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(PhaserParams, rate, "Rate", 0.05f, 5.0f, 1.0f, "Hz"),
+        INCANT_PARAM(PhaserParams, depth, "Depth", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(PhaserParams, feedback, "Feedback", 0.0f, 85.0f, 1.0f, "%"),
+        INCANT_PARAM(PhaserParams, stages, "Stages", 0.0f, 1.0f, 1.0f, ""),
+        INCANT_PARAM(PhaserParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+    }};
+};
+
+template <>
+struct ParameterTable<TremoloParams> {
+    static constexpr EffectType type = EffectType::Tremolo;
+    static constexpr std::array<ParameterDescriptor, 5> parameters{{
+        INCANT_PARAM(TremoloParams, rate, "Rate", 1.0f, 20.0f, 1.0f, "Hz"),
+        INCANT_PARAM(TremoloParams, depth, "Depth", 0.0f, 100.0f, 1.0f, "%"),
+        INCANT_PARAM(TremoloParams, shape, "Shape", 0.0f, 1.0f, 1.0f, ""),
+        INCANT_PARAM(TremoloParams, stereo, "Stereo", 0.0f, 180.0f, 1.0f, "deg"),
+        INCANT_PARAM(TremoloParams, dryWet, "Dry/Wet", 0.0f, 100.0f, 1.0f, "%"),
+    }};
+};
+
+template <>
+struct ParameterTable<FilterParams> {
+    static constexpr EffectType type = EffectType::Filter;
+    static constexpr std::array<ParameterDescriptor, 9> parameters{{
+        INCANT_PARAM(FilterParams, cutoff, "Cutoff", 20.0f, 20000.0f, kLogarithmic, "Hz"),
+        INCANT_PARAM(FilterParams, resonance, "Resonance", 0.5f, 20.0f, 1.0f, ""),
+        INCANT_PARAM(FilterParams, lfoRate, "LFO Rate", 0.1f, 10.0f, 1.0f, "Hz"),
+        INCANT_PARAM(FilterParams, lfoDepth, "LFO Depth", 0.0f, 2.0f, 1.0f, "oct"),
+        INCANT_PARAM(FilterParams, filterType, "Type", 0.0f, 1.0f, 1.0f, ""),
+        INCANT_PARAM(FilterParams, envDepth, "Env Depth", 0.0f, 4.0f, 1.0f, "oct"),
+        INCANT_PARAM(FilterParams, envAttack, "Env Attack", 0.1f, 100.0f, 1.0f, "ms"),
+        INCANT_PARAM(FilterParams, envRelease, "Env Release", 10.0f, 1000.0f, 1.0f, "ms"),
+        INCANT_PARAM(FilterParams, envSource, "Env Source", 0.0f, 1.0f, 1.0f, ""),
+    }};
+};
+
+#undef INCANT_PARAM
+
+// Number of parameters of a params struct, at compile time
+template <typename Params>
+constexpr int numParameters() {
+    return static_cast<int>(ParameterTable<Params>::parameters.size());
+}
+
+template <typename Params>
+constexpr const ParameterDescriptor* findParameter(int index) {
+    return index >= 0 && index < numParameters<Params>()
+        ? &ParameterTable<Params>::parameters[static_cast<std::size_t>(index)]
+        : nullptr;
+}
+
+template <typename Params>
+constexpr const char* parameterName(int index) {
+    const auto* descriptor = findParameter<Params>(index);
+    return descriptor != nullptr ? descriptor->name : "";
+}
+
+// The float behind a parameter index, or nullptr when out of range
+template <typename Params>
+float* parameterField(Params& params, int index) {
+    const auto* descriptor = findParameter<Params>(index);
+    if (descriptor == nullptr) return nullptr;
+    return reinterpret_cast<float*>(reinterpret_cast<char*>(&params) + descriptor->offset);
+}
+
+template <typename Params>
+const float* parameterField(const Params& params, int index) {
+    return parameterField(const_cast<Params&>(params), index);
+}
+
+template <typename Params>
+float getParameterValue(const Params& params, int index) {
+    const float* field = parameterField(params, index);
+    return field != nullptr ? *field : 0.0f;
+}
+
+// Runtime view of one effect type's table (editor, host parameters)
+struct ParameterList {
+    const ParameterDescriptor* descriptors = nullptr;
+    int size = 0;
+
+    constexpr const ParameterDescriptor* find(int index) const {
+        return index >= 0 && index < size ? descriptors + index : nullptr;
+    }
+};
+
+template <typename Params>
+constexpr ParameterList parameterList() {
+    return {ParameterTable<Params>::parameters.data(), numParameters<Params>()};
+}
+
+constexpr ParameterList getParameterList(EffectType type) {
+    switch (type) {
+        case EffectType::EQ: return parameterList<EQParams>();
+        case EffectType::Compressor: return parameterList<CompressorParams>();
+        case EffectType::Reverb: return parameterList<ReverbParams>();
+        case EffectType::Distortion: return parameterList<DistortionParams>();
+        case EffectType::Delay: return parameterList<DelayParams>();
+        case EffectType::Glitch: return parameterList<GlitchParams>();
+        case EffectType::Overdrive: return parameterList<OverdriveParams>();
+        case EffectType::Chorus: return parameterList<ChorusParams>();
+        case EffectType::Phaser: return parameterList<PhaserParams>();
+        case EffectType::Tremolo: return parameterList<TremoloParams>();
+        case EffectType::Filter: return parameterList<FilterParams>();
+    }
+    return {};
+}
+
+// Returns false for an index the struct doesn't have
+template <typename Params>
+bool setParameterValue(Params& params, int index, float value) {
+    float* field = parameterField(params, index);
+    if (field == nullptr) return false;
+    *field = value;
+    return true;
+}
+
+} // namespace incant
@@ -0,0 +1,104 @@
+#include "ParameterMapping.h"
+#include <cstring>
+
+namespace incant {
+
+MappingCurve::MappingCurve(Shape shape, float minValue, float maxValue, float skew)
+    : shape_(shape), min_(minValue), range_(maxValue - minValue)
+{
+    if (shape_ == Shape::Exponential) {
+        jassert(minValue > 0.0f && maxValue > 0.0f);
+        logRatio_ = std::log(maxValue / minValue);
+    }
+    if (shape_ == Shape::Skewed) {
+        jassert(skew > 0.0f);
+        inverseSkew_ = 1.0f / skew;
+    }
+}
+
+MappingCurve MappingCurve::forParameter(const ParameterDescriptor& descriptor) {
+    if (descriptor.skew == kLogarithmic) return exponential(descriptor.minValue, descriptor.maxValue);
+    if (std::strcmp(descriptor.unit, "dB") == 0) return decibels(descriptor.minValue, descriptor.maxValue);
+    if (descriptor.skew != 1.0f) return skewed(descriptor.minValue, descriptor.maxValue, descriptor.skew);
+    return linear(descriptor.minValue, descriptor.maxValue);
+}
+
+float MappingCurve::toNormalized(float physical) const {
+    if (range_ == 0.0f) return 0.0f;
+
+    float normalized = 0.0f;
+    switch (shape_) {
+        case Shape::Linear:
+        case Shape::Decibels:
+            normalized = (physical - min_) / range_;
+            break;
+        case Shape::Exponential:
+            normalized = physical > 0.0f ? std::log(physical / min_) / logRatio_ : 0.0f;
+            break;
+        case Shape::Skewed: {
+            const float proportion = (physical - min_) / range_;
+            normalized = proportion > 0.0f ? std::pow(proportion, 1.0f / inverseSkew_) : 0.0f;
+            break;
+        }
+    }
+    return juce::jlimit(0.0f, 1.0f, normalized);
+}
+
+ParameterMapping::ParameterMapping(const ParameterDescriptor& descriptor)
+    : curve_(MappingCurve::forParameter(descriptor)),
+      unit_(descriptor.unit),
+      plain_(descriptor.unit[0] == '\0')
+{
+    inverse_.build([this](float normalized) { return curve_.toPhysical(normalized); });
+}
+
+juce::String ParameterMapping::toText(float normalized) const {
+    if (plain_) return juce::String(normalized, 2);
+
+    const float value = curve_.toPhysical(normalized);
+    const juce::String unit(unit_);
+
+    if (unit == "Hz" && value >= 1000.0f) {
+        return juce::String(value / 1000.0f, value < 10000.0f ? 2 : 1) + " kHz";
+    }
+    if (unit == "%") {
+        return juce::String(juce::roundToInt(value)) + " %";
+    }
+
+    // Small values get a decimal, large ones don't need it
+    const int decimals = std::abs(value) < 100.0f ? 1 : 0;
+    return juce::String(value, decimals) + " " + unit;
+}
+
+float ParameterMapping::fromText(const juce::String& text) const {
+    const auto trimmed = text.trim();
+    float value = trimmed.getFloatValue();
+    if (plain_) return juce::jlimit(0.0f, 1.0f, value);
+
+    if (juce::String(unit_) == "Hz" && trimmed.containsIgnoreCase("k")) {
+        value *= 1000.0f;
+    }
+    return inverse_.inverse(value);
+}
+
+const ParameterMapping& getParameterMapping(EffectType type, int index) {
+    static const auto mappings = [] {
+        std::array<std::vector<ParameterMapping>, kNumEffectTypes> result;
+        for (int t = 0; t < kNumEffectTypes; ++t) {
+            const auto list = getParameterList(static_cast<EffectType>(t));
+            auto& mappingsForType = result[static_cast<size_t>(t)];
+            mappingsForType.reserve(static_cast<size_t>(list.size));
+            for (int i = 0; i < list.size; ++i) {
+                mappingsForType.emplace_back(list.descriptors[i]);
+            }
+        }
+        return result;
+    }();
+
+    static const ParameterMapping none;
+    const auto& mappingsForType = mappings[static_cast<size_t>(type)];
+    if (index < 0 || index >= static_cast<int>(mappingsForType.size())) return none;
+    return mappingsForType[static_cast<size_t>(index)];
+}
+
+} // namespace incant
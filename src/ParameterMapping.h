@@ -0,0 +1,149 @@
+#pragma once
+
+#include "ParameterDescriptors.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace incant {
+
+// Normalized (0-1) to physical mapping of one parameter. Everything that
+// doesn't depend on the value (range, log ratio, inverse skew) is computed
+// once, so a conversion is a multiply-add or a single exp.
+class MappingCurve {
+public:
+    enum class Shape {
+        Linear,         // min + x * (max - min)
+        Exponential,    // min * (max / min)^x: frequencies, Q
+        Decibels,       // linear in dB; toGain() gives the amplitude
+        Skewed          // min + x^(1/skew) * (max - min), JUCE's skew
+    };
+
+    MappingCurve() = default;
+    MappingCurve(Shape shape, float minValue, float maxValue, float skew = 1.0f);
+
+    static MappingCurve linear(float minValue, float maxValue) { return {Shape::Linear, minValue, maxValue}; }
+    static MappingCurve exponential(float minValue, float maxValue) { return {Shape::Exponential, minValue, maxValue}; }
+    static MappingCurve decibels(float minDb, float maxDb) { return {Shape::Decibels, minDb, maxDb}; }
+    static MappingCurve skewed(float minValue, float maxValue, float skew) { return {Shape::Skewed, minValue, maxValue, skew}; }
+
+    // Shape from the descriptor: logarithmic ranges are exponential, dB
+    // ranges are decibel curves, other skews are skewed
+    static MappingCurve forParameter(const ParameterDescriptor& descriptor);
+
+    // In the parameter's unit (dB for decibel curves)
+    float toPhysical(float normalized) const {
+        switch (shape_) {
+            case Shape::Linear:
+            case Shape::Decibels: return min_ + normalized * range_;
+            case Shape::Exponential: return min_ * std::exp(normalized * logRatio_);
+            case Shape::Skewed: return min_ + std::pow(normalized, inverseSkew_) * range_;
+        }
+        return min_;
+    }
+
+    float toNormalized(float physical) const;
+
+    // Linear amplitude of a decibel curve's value
+    float toGain(float normalized) const { return std::exp(toPhysical(normalized) * kNepersPerDb); }
+
+    Shape getShape() const { return shape_; }
+    float getMinimum() const { return min_; }
+    float getMaximum() const { return min_ + range_; }
+
+private:
+    static constexpr float kNepersPerDb = 0.11512925f;   // ln(10) / 20
+
+    Shape shape_ = Shape::Linear;
+    float min_ = 0.0f;
+    float range_ = 1.0f;
+    float logRatio_ = 0.0f;
+    float inverseSkew_ = 1.0f;
+};
+
+// A function of a normalized value sampled densely over 0..1.
+//
+// Effects build one at prepare time for anything they'd otherwise evaluate
+// per sample (e.g. cutoff -> filter coefficient), and look it up with linear
+// interpolation. For monotonic functions inverse() maps a value back to its
+// normalized position without evaluating the function, which is what the GUI
+// needs for text entry.
+template <int Resolution>
+class MappingTable {
+public:
+    static_assert(Resolution >= 2, "need at least two segments");
+
+    template <typename Function>
+    void build(Function&& function) {
+        for (int i = 0; i <= Resolution; ++i) {
+            values_[static_cast<size_t>(i)] = function(static_cast<float>(i) / static_cast<float>(Resolution));
+        }
+    }
+
+    float operator()(float normalized) const {
+        const float position = std::clamp(normalized, 0.0f, 1.0f) * static_cast<float>(Resolution);
+        const int index = std::min(static_cast<int>(position), Resolution - 1);
+        const float frac = position - static_cast<float>(index);
+        const float a = values_[static_cast<size_t>(index)];
+        return a + frac * (values_[static_cast<size_t>(index + 1)] - a);
+    }
+
+    float inverse(float value) const {
+        const bool rising = values_.back() >= values_.front();
+        const auto below = [rising](float entry, float v) { return rising ? entry < v : entry > v; };
+
+        const auto upper = std::lower_bound(values_.begin(), values_.end(), value, below);
+        if (upper == values_.begin()) return 0.0f;
+        if (upper == values_.end()) return 1.0f;
+
+        const auto index = static_cast<int>(upper - values_.begin()) - 1;
+        const float a = values_[static_cast<size_t>(index)];
+        const float b = *upper;
+        const float frac = b != a ? (value - a) / (b - a) : 0.0f;
+        return (static_cast<float>(index) + frac) / static_cast<float>(Resolution);
+    }
+
+private:
+    std::array<float, Resolution + 1> values_{};
+};
+
+// The curve of one parameter of a params struct, built once
+template <typename Params>
+const MappingCurve& parameterCurve(int index) {
+    static const auto curves = [] {
+        std::array<MappingCurve, ParameterTable<Params>::parameters.size()> result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = MappingCurve::forParameter(ParameterTable<Params>::parameters[i]);
+        }
+        return result;
+    }();
+    return curves[static_cast<size_t>(juce::jlimit(0, numParameters<Params>() - 1, index))];
+}
+
+// What the editor and the host show for one parameter: the same curve the
+// effect uses, formatted in the descriptor's unit, plus a dense inverse so
+// typed-in values map back without evaluating the curve.
+class ParameterMapping {
+public:
+    ParameterMapping() = default;
+    explicit ParameterMapping(const ParameterDescriptor& descriptor);
+
+    juce::String toText(float normalized) const;
+    float fromText(const juce::String& text) const;
+
+    const MappingCurve& getCurve() const { return curve_; }
+    const char* getUnit() const { return unit_; }
+
+private:
+    MappingCurve curve_;
+    MappingTable<256> inverse_;
+    const char* unit_ = "";
+    bool plain_ = true;   // unitless switches and choices show the raw 0-1 value
+};
+
+// Any thread; the mappings of every effect are built on first use
+const ParameterMapping& getParameterMapping(EffectType type, int index);
+
+} // namespace incant
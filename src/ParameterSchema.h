@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <map>
 
@@ -19,13 +20,38 @@ enum class EffectType {
     Filter
 };
 
+constexpr int kNumEffectTypes = static_cast<int>(EffectType::Filter) + 1;
+
 // Normalized parameters (0.0 to 1.0) for each effect type
+struct EQBandParams {
+    float enabled = 0.0f;      // >= 0.5 band is processed
+    float type = 0.0f;         // 0=peak, 0.2=low shelf, 0.4=high shelf, 0.6=low cut, 0.8=high cut, 1=notch
+    float frequency = 0.5f;    // 20Hz to 20kHz (log)
+    float q = 0.4247f;         // 0.1 to 10 (log), 0.4247 = 0.707
+    float gain = 0.5f;         // -12 to +12 dB, 0.5 = 0dB
+    float dynamic = 0.0f;      // 0 = static, 1 = gain fully follows the band level
+    float threshold = 0.5f;    // Dynamic threshold, -60 to 0 dB
+};
+
 struct EQParams {
-    float lowGain = 0.5f;      // -12 to +12 dB, 0.5 = 0dB
-    float midGain = 0.5f;
-    float highGain = 0.5f;
-    float airGain = 0.5f;
+    static constexpr int kMaxBands = 16;
+    enum Band { Low = 0, Mid, High, Air };
+
+    // Bands 1-4 default to the original low shelf / mid / high / air layout
+    std::array<EQBandParams, kMaxBands> bands{{
+        {1.0f, 0.2f, 0.2330f, 0.4247f},  // Low shelf, 100 Hz
+        {1.0f, 0.0f, 0.5663f, 0.4247f},  // Mid peak, 1 kHz
+        {1.0f, 0.0f, 0.7670f, 0.4247f},  // High peak, 4 kHz
+        {1.0f, 0.4f, 0.8997f, 0.4247f},  // Air shelf, 10 kHz
+    }};
     float dryWet = 1.0f;
+    float linearPhase = 0.0f;  // >= 0.5 runs as a linear-phase FIR (adds latency)
+};
+
+struct CompressorBandParams {
+    float threshold = 0.5f;    // -60 to 0 dB
+    float ratio = 0.25f;       // 1:1 to 20:1
+    float gain = 0.5f;         // -12 to +12 dB
 };
 
 struct CompressorParams {
@@ -34,6 +60,16 @@ struct CompressorParams {
     float attack = 0.1f;       // 0.1 to 100 ms
     float release = 0.3f;      // 10 to 1000 ms
     float makeup = 0.5f;       // 0 to 24 dB
+    float knee = 0.0f;         // 0 to 24 dB (0 = hard knee)
+    float lookahead = 0.0f;    // 0 to 10 ms
+    float detector = 0.0f;     // < 0.5 peak, >= 0.5 RMS
+    float link = 0.0f;         // 0 = independent channels, 1 = fully linked
+    float multiband = 0.0f;    // < 0.5 single band, >= 0.5 four bands
+    float crossoverLow = 0.4f; // 40 to 400 Hz
+    float crossoverMid = 0.5f; // 200 to 2000 Hz
+    float crossoverHigh = 0.5f; // 2 to 16 kHz
+    std::array<CompressorBandParams, 4> bands{};
+    float sidechain = 0.0f;    // < 0.5 key from input, >= 0.5 key from sidechain bus
 };
 
 struct ReverbParams {
@@ -105,6 +141,10 @@ struct FilterParams {
     float lfoRate = 0.3f;      // LFO modulation rate
     float lfoDepth = 0.0f;     // LFO modulation depth
     float filterType = 0.0f;   // 0=lowpass, 0.33=highpass, 0.66=bandpass, 1=notch
+    float envDepth = 0.0f;     // Envelope follower -> cutoff, 0 to +4 octaves
+    float envAttack = 0.1f;    // 0.1 to 100 ms
+    float envRelease = 0.2f;   // 10 to 1000 ms
+    float envSource = 0.0f;    // < 0.5 input, >= 0.5 sidechain bus
 };
 
 // JSON keys for LLM communication
@@ -125,13 +165,32 @@ inline const char* getEffectTypeName(EffectType type) {
     return "unknown";
 }
 
+// Names shown to users (host automation lanes)
+inline const char* getEffectDisplayName(EffectType type) {
+    switch (type) {
+        case EffectType::EQ: return "Equalizer";
+        case EffectType::Compressor: return "Compressor";
+        case EffectType::Reverb: return "Reverb";
+        case EffectType::Distortion: return "Distortion";
+        case EffectType::Delay: return "Delay";
+        case EffectType::Glitch: return "Glitch";
+        case EffectType::Overdrive: return "Overdrive";
+        case EffectType::Chorus: return "Chorus";
+        case EffectType::Phaser: return "Phaser";
+        case EffectType::Tremolo: return "Tremolo";
+        case EffectType::Filter: return "Filter";
+    }
+    return "Unknown";
+}
+
+// The description comes last: everything before it is the same for every
+// cast of an effect, so the LLM engine can keep it prefilled
 inline const char* getPromptTemplate(EffectType type) {
     switch (type) {
         case EffectType::EQ:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
-Effect: EQ (4-band equalizer)
-Description: "%s"
+Effect: EQ (parametric equalizer, up to 16 bands)
 
 Output parameters as floats 0.0-1.0:
 - lowGain: bass boost/cut (0.5=neutral)
@@ -139,14 +198,23 @@ Output parameters as floats 0.0-1.0:
 - highGain: treble (0.5=neutral)
 - airGain: upper harmonics (0.5=neutral)
 - dryWet: effect amount (1.0=full)
+- linearPhase: 1 for no phase shift (mastering, adds latency), 0 otherwise
+Optional extra bands N=5..16 (bands 1-4 are low, mid, high, air):
+- bandNEnabled: 1 to use the band
+- bandNType: 0=peak, 0.2=low shelf, 0.4=high shelf, 0.6=low cut, 0.8=high cut, 1=notch
+- bandNFreq: frequency (0=20Hz, 0.5=630Hz, 1=20kHz)
+- bandNQ: width (0=wide, 1=narrow)
+- bandNGain: boost/cut (0.5=neutral)
+- bandNDynamic: 0=static, 1=only applies when the band gets loud
+- bandNThreshold: dynamic threshold (0=-60dB, 1=0dB)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Compressor:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Compressor
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - threshold: compression threshold (0=heavy, 1=light)
@@ -154,14 +222,23 @@ Output parameters as floats 0.0-1.0:
 - attack: attack speed (0=fast, 1=slow)
 - release: release speed (0=fast, 1=slow)
 - makeup: makeup gain (0=none, 1=max)
+- knee: knee softness (0=hard, 1=very soft)
+- lookahead: lookahead time (0=none, 1=10ms)
+- detector: level detector (0=peak, 1=RMS)
+- link: stereo link (0=independent, 1=linked)
+- multiband: 0=single band, 1=four bands (use for mastering or tonal problems)
+- crossoverLow, crossoverMid, crossoverHigh: band split points (0=lower, 1=higher)
+- band1Threshold..band4Threshold, band1Ratio..band4Ratio, band1Gain..band4Gain:
+  per-band settings, band1=lows, band4=highs (gain 0.5=unity)
+- sidechain: detector key (0=input, 1=external sidechain, e.g. ducking)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Reverb:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Reverb
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - size: room size (0=small, 1=huge)
@@ -170,13 +247,13 @@ Output parameters as floats 0.0-1.0:
 - predelay: initial delay (0=none, 1=long)
 - dryWet: wet/dry mix (0=dry, 1=wet)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Distortion:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Distortion
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - drive: distortion amount (0=clean, 1=destroyed)
@@ -184,13 +261,13 @@ Output parameters as floats 0.0-1.0:
 - dryWet: wet/dry mix (0=clean, 1=full distortion)
 - curveType: distortion character (0=soft, 0.33=hard, 0.66=tube, 1=fuzz)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Delay:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Delay
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - time: delay time (0=short ~10ms, 1=long ~1000ms)
@@ -199,13 +276,13 @@ Output parameters as floats 0.0-1.0:
 - pingPong: stereo spread (0=mono, 1=full ping-pong)
 - dryWet: wet/dry mix (0=dry, 1=wet)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Glitch:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Glitch
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - rate: glitch frequency (0=sparse, 1=constant chaos)
@@ -214,13 +291,13 @@ Output parameters as floats 0.0-1.0:
 - reverse: reverse probability (0=never, 1=always)
 - dryWet: wet/dry mix (0=dry, 1=wet)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Overdrive:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Overdrive (Tubescreamer-style)
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - drive: gain/saturation amount (0=clean, 1=heavy crunch)
@@ -229,13 +306,13 @@ Output parameters as floats 0.0-1.0:
 - midBoost: mid-frequency emphasis (0=flat, 1=honky mids)
 - tightness: low-end cut (0=loose/full, 1=tight/focused)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Chorus:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Chorus
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - rate: modulation speed (0=slow, 1=fast)
@@ -244,13 +321,13 @@ Output parameters as floats 0.0-1.0:
 - feedback: resonance (0=none, 1=metallic)
 - dryWet: wet/dry mix (0=dry, 1=wet)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Phaser:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Phaser
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - rate: sweep speed (0=slow, 1=fast)
@@ -259,13 +336,13 @@ Output parameters as floats 0.0-1.0:
 - stages: complexity (0=4-stage, 0.5=8-stage, 1=12-stage)
 - dryWet: wet/dry mix (0=dry, 1=wet)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Tremolo:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Tremolo
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - rate: speed (0=slow pulse, 1=fast helicopter)
@@ -274,13 +351,13 @@ Output parameters as floats 0.0-1.0:
 - stereo: stereo spread (0=mono, 1=ping-pong)
 - dryWet: effect amount (1.0=full effect)
 
+Description: "%s"
 JSON:)";
 
         case EffectType::Filter:
             return R"(You are an audio effect parameter generator. Output only valid JSON, no explanation.
 
 Effect: Filter (Resonant)
-Description: "%s"
 
 Output parameters as floats 0.0-1.0:
 - cutoff: filter frequency (0=low, 1=high)
@@ -288,7 +365,12 @@ Output parameters as floats 0.0-1.0:
 - lfoRate: modulation speed (0=slow, 1=fast)
 - lfoDepth: modulation amount (0=static, 1=full sweep)
 - filterType: type (0=lowpass, 0.33=highpass, 0.66=bandpass, 1=notch)
+- envDepth: envelope follower to cutoff (0=off, 1=+4 octaves)
+- envAttack: envelope attack (0=fast, 1=slow)
+- envRelease: envelope release (0=fast, 1=slow)
+- envSource: envelope key (0=input, 1=sidechain)
 
+Description: "%s"
 JSON:)";
     }
     return "";
@@ -1,4 +1,5 @@
 #include "PluginEditor.h"
+#include "ParameterMapping.h"
 #include <cmath>
 
 namespace incant {
@@ -97,9 +98,7 @@ void MysticalKnob::paint(juce::Graphics& g) {
 // LevelMeter Implementation
 //==============================================================================
 
-LevelMeter::LevelMeter() {
-    startTimerHz(30);
-}
+LevelMeter::LevelMeter() = default;
 
 void LevelMeter::paint(juce::Graphics& g) {
     auto bounds = getLocalBounds().toFloat().reduced(2.0f);
@@ -149,36 +148,138 @@ void LevelMeter::paint(juce::Graphics& g) {
     }
 }
 
-void LevelMeter::timerCallback() {
+bool LevelMeter::advanceFrame(double deltaSeconds) {
+    // Ballistics were tuned per frame at 30fps; scale them to the actual step
+    const float frames = static_cast<float>(deltaSeconds * 30.0);
+    const float previousLevel = currentLevel_;
+    const float previousPeak = peakLevel_;
+
     // Smooth decay
-    currentLevel_ += (targetLevel_ - currentLevel_) * 0.3f;
+    currentLevel_ += (targetLevel_ - currentLevel_) * (1.0f - std::pow(0.7f, frames));
+    if (std::abs(targetLevel_ - currentLevel_) < 0.0005f) currentLevel_ = targetLevel_;
 
     // Peak hold and decay
     if (targetLevel_ > peakLevel_) {
         peakLevel_ = targetLevel_;
-        peakHoldCounter_ = 30; // Hold for ~1 second
-    } else if (peakHoldCounter_ > 0) {
-        --peakHoldCounter_;
+        peakHoldSeconds_ = 1.0;
+    } else if (peakHoldSeconds_ > 0.0) {
+        peakHoldSeconds_ -= deltaSeconds;
     } else {
-        peakLevel_ *= 0.95f;
+        peakLevel_ *= std::pow(0.95f, frames);
+        if (peakLevel_ < 0.01f) peakLevel_ = 0.0f;  // indicator is hidden below this anyway
     }
 
-    repaint();
+    // At rest nothing repaints, so a silent meter lets the scheduler idle
+    const bool changed = currentLevel_ != previousLevel || peakLevel_ != previousPeak;
+    if (changed) repaint();
+    return changed;
 }
 
 void LevelMeter::setLevel(float level) {
     targetLevel_ = juce::jlimit(0.0f, 1.0f, level);
 }
 
+//==============================================================================
+// SpectrumDisplay Implementation
+//==============================================================================
+
+SpectrumDisplay::SpectrumDisplay(SpectrumAnalyzer& pre, SpectrumAnalyzer& post)
+    : pre_(pre), post_(post)
+{
+    preBands_.fill(SpectrumAnalyzer::kMinDb);
+    postBands_.fill(SpectrumAnalyzer::kMinDb);
+
+    pre_.setActive(true);
+    post_.setActive(true);
+}
+
+SpectrumDisplay::~SpectrumDisplay() {
+    pre_.setActive(false);
+    post_.setActive(false);
+}
+
+void SpectrumDisplay::paint(juce::Graphics& g) {
+    auto bounds = getLocalBounds().toFloat();
+
+    // Background
+    g.setColour(juce::Colour(0xFF1a1a24));
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    // Decade grid: 100Hz, 1kHz, 10kHz on the 20Hz-20kHz axis
+    g.setColour(juce::Colour(0xFF2a2a38));
+    for (float decade : {100.0f, 1000.0f, 10000.0f}) {
+        const float x = bounds.getX() + bounds.getWidth() * std::log(decade / 20.0f) / std::log(1000.0f);
+        g.drawVerticalLine(static_cast<int>(x), bounds.getY(), bounds.getBottom());
+    }
+
+    // Input as a dim fill, output as a gold line on top
+    g.setColour(juce::Colour(0x406b4c9a));
+    g.fillPath(prePath_);
+
+    g.setColour(juce::Colour(0xFFd4a558));
+    g.strokePath(postPath_, juce::PathStrokeType(1.5f, juce::PathStrokeType::curved,
+                                                  juce::PathStrokeType::rounded));
+
+    // Border
+    g.setColour(juce::Colour(0xFF2a2a38));
+    g.drawRoundedRectangle(bounds.reduced(0.5f), 4.0f, 1.0f);
+}
+
+void SpectrumDisplay::resized() {
+    buildPath(preBands_, prePath_, true);
+    buildPath(postBands_, postPath_, false);
+}
+
+bool SpectrumDisplay::advanceFrame(double /*deltaSeconds*/) {
+    // Only the few band levels cross threads; paths are rebuilt when they change
+    const bool preChanged = pre_.getBands(preBands_, preVersion_);
+    const bool postChanged = post_.getBands(postBands_, postVersion_);
+
+    if (preChanged) buildPath(preBands_, prePath_, true);
+    if (postChanged) buildPath(postBands_, postPath_, false);
+    if (preChanged || postChanged) repaint();
+    return preChanged || postChanged;
+}
+
+void SpectrumDisplay::buildPath(const SpectrumAnalyzer::Bands& bands, juce::Path& path, bool closed) const {
+    const auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+    const float step = bounds.getWidth() / static_cast<float>(SpectrumAnalyzer::kNumBands - 1);
+
+    auto levelToY = [&bounds](float db) {
+        return juce::jmap(juce::jlimit(SpectrumAnalyzer::kMinDb, 0.0f, db),
+                          SpectrumAnalyzer::kMinDb, 0.0f, bounds.getBottom(), bounds.getY());
+    };
+
+    path.clear();
+    path.preallocateSpace(3 * (SpectrumAnalyzer::kNumBands + 3));
+    if (closed) {
+        path.startNewSubPath(bounds.getX(), bounds.getBottom());
+        path.lineTo(bounds.getX(), levelToY(bands[0]));
+    } else {
+        path.startNewSubPath(bounds.getX(), levelToY(bands[0]));
+    }
+
+    for (int b = 1; b < SpectrumAnalyzer::kNumBands; ++b) {
+        path.lineTo(bounds.getX() + step * static_cast<float>(b), levelToY(bands[static_cast<size_t>(b)]));
+    }
+
+    if (closed) {
+        path.lineTo(bounds.getRight(), bounds.getBottom());
+        path.closeSubPath();
+    }
+}
+
 //==============================================================================
 // IncantEditor Implementation
 //==============================================================================
 
 IncantEditor::IncantEditor(IncantProcessor& processor)
-    : AudioProcessorEditor(processor), processor_(processor)
+    : AudioProcessorEditor(processor), processor_(processor),
+      spectrum_(processor.getInputAnalyzer(), processor.getOutputAnalyzer()),
+      animator_(*this)
 {
-    setSize(700, 550);
-    startTimerHz(30);
+    setOpaque(true);
+    setSize(700, 650);
 
     // Title
     titleLabel_.setText("INCANT", juce::dontSendNotification);
@@ -264,14 +365,13 @@ IncantEditor::IncantEditor(IncantProcessor& processor)
     statusLabel_.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(statusLabel_);
 
-    // Knobs
+    // Knobs sit on top of the animated rune circle; caching them means those
+    // repaints just blit them unless their value changed
     for (int i = 0; i < NUM_KNOBS; ++i) {
+        knobs_[static_cast<size_t>(i)].setBufferedToImage(true);
         addAndMakeVisible(knobs_[static_cast<size_t>(i)]);
         knobs_[static_cast<size_t>(i)].onValueChange = [this, i] {
-            auto* effect = processor_.getCurrentEffect();
-            if (effect && i < effect->getNumParameters()) {
-                effect->setParameter(i, static_cast<float>(knobs_[static_cast<size_t>(i)].getValue()));
-            }
+            processor_.setEffectParameter(i, static_cast<float>(knobs_[static_cast<size_t>(i)].getValue()));
         };
 
         knobLabels_[static_cast<size_t>(i)].setFont(juce::FontOptions(11.0f));
@@ -301,19 +401,55 @@ IncantEditor::IncantEditor(IncantProcessor& processor)
     outputLabel_.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(outputLabel_);
 
+    // Spectrum
+    addAndMakeVisible(spectrum_);
+
+    // The editor goes first so the meters see this frame's levels
+    animator_.addClient(*this);
+    animator_.addClient(inputMeter_);
+    animator_.addClient(outputMeter_);
+    animator_.addClient(spectrum_);
+
     updateKnobsForEffect();
 }
 
 IncantEditor::~IncantEditor() {
-    stopTimer();
+    processor_.setEditorFocused(false);
+}
+
+void IncantEditor::focusOfChildComponentChanged(FocusChangeType /*cause*/) {
+    // This instance's casts go ahead of other instances' while the user works in it
+    processor_.setEditorFocused(hasKeyboardFocus(true));
 }
 
 void IncantEditor::paint(juce::Graphics& g) {
+    // Re-render the static layers only when the size or pixel scale changed
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (backgroundCache_.isNull() || scale != backgroundCacheScale_) {
+        renderBackgroundCache(scale);
+    }
+
+    auto bounds = getLocalBounds().toFloat();
+    g.drawImage(backgroundCache_, bounds);
+
+    // Animated part of the rune circle
+    drawRuneMarks(g, bounds.getCentreX(), bounds.getHeight() * 0.65f, kRuneRadius);
+}
+
+void IncantEditor::renderBackgroundCache(float scale) {
+    const int width = std::max(1, juce::roundToInt(static_cast<float>(getWidth()) * scale));
+    const int height = std::max(1, juce::roundToInt(static_cast<float>(getHeight()) * scale));
+
+    backgroundCache_ = juce::Image(juce::Image::RGB, width, height, false);
+    backgroundCacheScale_ = scale;
+
+    juce::Graphics g(backgroundCache_);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     drawMysticalBackground(g);
 
-    // Decorative rune circle
     auto bounds = getLocalBounds().toFloat();
-    drawRuneCircle(g, bounds.getCentreX(), bounds.getHeight() * 0.65f, 180.0f);
+    drawRuneCircle(g, bounds.getCentreX(), bounds.getHeight() * 0.65f, kRuneRadius);
 }
 
 void IncantEditor::drawMysticalBackground(juce::Graphics& g) {
@@ -328,12 +464,9 @@ void IncantEditor::drawMysticalBackground(juce::Graphics& g) {
     g.setGradientFill(bgGradient);
     g.fillRect(bounds);
 
-    // Subtle radial glow from center
-    float glowPhase = backgroundPhase_ * 0.5f;
-    float glowIntensity = 0.15f + 0.05f * std::sin(glowPhase);
-
+    // Subtle radial glow from center (static so the whole window never needs repainting)
     juce::ColourGradient centerGlow(
-        Colors::purple.withAlpha(glowIntensity), bounds.getCentreX(), bounds.getHeight() * 0.6f,
+        Colors::purple.withAlpha(0.15f), bounds.getCentreX(), bounds.getHeight() * 0.6f,
         juce::Colours::transparentBlack, bounds.getCentreX(), 0.0f,
         true
     );
@@ -352,8 +485,6 @@ void IncantEditor::drawMysticalBackground(juce::Graphics& g) {
 }
 
 void IncantEditor::drawRuneCircle(juce::Graphics& g, float cx, float cy, float radius) {
-    float phase = backgroundPhase_;
-
     // Outer circle
     g.setColour(Colors::purple.withAlpha(0.3f));
     g.drawEllipse(cx - radius, cy - radius, radius * 2.0f, radius * 2.0f, 1.5f);
@@ -362,6 +493,10 @@ void IncantEditor::drawRuneCircle(juce::Graphics& g, float cx, float cy, float r
     float innerRadius = radius * 0.7f;
     g.setColour(Colors::purple.withAlpha(0.2f));
     g.drawEllipse(cx - innerRadius, cy - innerRadius, innerRadius * 2.0f, innerRadius * 2.0f, 1.0f);
+}
+
+void IncantEditor::drawRuneMarks(juce::Graphics& g, float cx, float cy, float radius) {
+    float phase = backgroundPhase_;
 
     // Rotating rune marks
     g.setColour(Colors::accent.withAlpha(0.4f));
@@ -399,6 +534,14 @@ void IncantEditor::drawRuneCircle(juce::Graphics& g, float cx, float cy, float r
 }
 
 void IncantEditor::resized() {
+    backgroundCache_ = juce::Image();
+
+    // Rune circle plus room for its stroke widths
+    const auto runeCentre = juce::Point<float>(static_cast<float>(getWidth()) * 0.5f,
+                                               static_cast<float>(getHeight()) * 0.65f);
+    runeArea_ = juce::Rectangle<float>(kRuneRadius * 2.0f, kRuneRadius * 2.0f)
+                    .withCentre(runeCentre).expanded(4.0f).getSmallestIntegerContainer();
+
     auto bounds = getLocalBounds().reduced(20);
 
     // Title area
@@ -423,6 +566,10 @@ void IncantEditor::resized() {
     statusLabel_.setBounds(bounds.removeFromTop(25));
     bounds.removeFromTop(20);
 
+    // Spectrum along the bottom
+    spectrum_.setBounds(bounds.removeFromBottom(90));
+    bounds.removeFromBottom(10);
+
     // Meters on the sides
     auto meterWidth = 25;
     auto meterArea = bounds.reduced(0, 20);
@@ -441,7 +588,7 @@ void IncantEditor::resized() {
     int knobSpacing = (knobArea.getWidth() - knobSize * NUM_KNOBS) / (NUM_KNOBS - 1);
 
     auto* effect = processor_.getCurrentEffect();
-    int numParams = effect ? effect->getNumParameters() : 0;
+    int numParams = effect ? std::min(effect->getNumParameters(), NUM_KNOBS) : 0;
 
     int startX = knobArea.getX() + (knobArea.getWidth() - (numParams * knobSize + (numParams - 1) * knobSpacing)) / 2;
 
@@ -462,22 +609,30 @@ void IncantEditor::resized() {
     }
 }
 
-void IncantEditor::timerCallback() {
+bool IncantEditor::advanceFrame(double deltaSeconds) {
+    bool changed = false;
+
     // Update meters
     inputMeter_.setLevel(processor_.getInputLevel() * 3.0f); // Scale for visibility
     outputMeter_.setLevel(processor_.getOutputLevel() * 3.0f);
 
-    // Update knob value displays
-    auto* effect = processor_.getCurrentEffect();
-    if (effect) {
-        for (int i = 0; i < effect->getNumParameters(); ++i) {
-            float value = effect->getParameter(i);
-            knobValueLabels_[static_cast<size_t>(i)].setText(
-                juce::String(value, 2), juce::dontSendNotification);
-
-            // Sync knob position if it changed externally
-            if (std::abs(static_cast<float>(knobs_[static_cast<size_t>(i)].getValue()) - value) > 0.001f) {
-                knobs_[static_cast<size_t>(i)].setValue(value, juce::dontSendNotification);
+    // Knobs and labels only follow actual changes: one atomic load per frame
+    // when nothing moved, then a version check per knob
+    if (processor_.getEffectType() != shownEffect_) {
+        effectSelector_.setSelectedId(static_cast<int>(processor_.getEffectType()) + 1, juce::dontSendNotification);
+        updateKnobsForEffect();
+        changed = true;
+    } else {
+        const juce::uint32 changeCount = processor_.getParameterChangeCount();
+        if (changeCount != shownChangeCount_) {
+            shownChangeCount_ = changeCount;
+            for (int i = 0; i < NUM_KNOBS; ++i) {
+                const juce::uint32 version = processor_.getParameterVersion(i);
+                if (version != knobVersions_[static_cast<size_t>(i)]) {
+                    knobVersions_[static_cast<size_t>(i)] = version;
+                    refreshKnob(i);
+                    changed = true;
+                }
             }
         }
     }
@@ -488,15 +643,36 @@ void IncantEditor::timerCallback() {
         statusLabel_.setText("Channeling the arcane...", juce::dontSendNotification);
         statusLabel_.setColour(juce::Label::textColourId, Colors::accent);
         isGenerating_ = true;
+    } else if (status == LLMEngine::Status::Loading) {
+        const int percent = juce::roundToInt(processor_.getLLMLoadProgress() * 100.0f);
+        if (percent != shownLoadPercent_) {
+            shownLoadPercent_ = percent;
+            statusLabel_.setText("Waking the grimoire... " + juce::String(percent) + "%", juce::dontSendNotification);
+            statusLabel_.setColour(juce::Label::textColourId, Colors::accent);
+            changed = true;
+        }
     } else if (isGenerating_) {
         statusLabel_.setText("Spell complete!", juce::dontSendNotification);
         statusLabel_.setColour(juce::Label::textColourId, Colors::success);
         isGenerating_ = false;
+        shownLoadPercent_ = -1;
+        changed = true;
+    } else if (shownLoadPercent_ >= 0) {
+        statusLabel_.setText("Ready to cast", juce::dontSendNotification);
+        statusLabel_.setColour(juce::Label::textColourId, Colors::success);
+        shownLoadPercent_ = -1;
+        changed = true;
+    }
+
+    // Rune marks turn while audio is flowing or a spell is being cast
+    // (0.02 per frame at the original 30fps); everything else repaints itself
+    if (isGenerating_ || processor_.getOutputLevel() > 0.001f) {
+        backgroundPhase_ += static_cast<float>(deltaSeconds * 0.6);
+        repaint(runeArea_);
+        changed = true;
     }
 
-    // Animate background
-    backgroundPhase_ += 0.02f;
-    repaint();
+    return changed;
 }
 
 void IncantEditor::onCastSpell() {
@@ -505,6 +681,7 @@ void IncantEditor::onCastSpell() {
         statusLabel_.setText("Casting...", juce::dontSendNotification);
         statusLabel_.setColour(juce::Label::textColourId, Colors::accent);
         processor_.generateFromText(text);
+        animator_.wake();
     }
 }
 
@@ -517,21 +694,40 @@ void IncantEditor::onEffectTypeChanged() {
 }
 
 void IncantEditor::updateKnobsForEffect() {
+    // Take the change state before reading values so nothing newer is missed
+    shownEffect_ = processor_.getEffectType();
+    shownChangeCount_ = processor_.getParameterChangeCount();
+
     auto* effect = processor_.getCurrentEffect();
     if (!effect) return;
 
     int numParams = effect->getNumParameters();
 
     for (int i = 0; i < NUM_KNOBS; ++i) {
+        knobVersions_[static_cast<size_t>(i)] = processor_.getParameterVersion(i);
         if (i < numParams) {
             knobLabels_[static_cast<size_t>(i)].setText(
                 effect->getParameterName(i), juce::dontSendNotification);
-            knobs_[static_cast<size_t>(i)].setValue(
-                effect->getParameter(i), juce::dontSendNotification);
+            refreshKnob(i);
         }
     }
 
     resized();
 }
 
+void IncantEditor::refreshKnob(int index) {
+    auto* effect = processor_.getCurrentEffect();
+    if (!effect || index >= effect->getNumParameters()) return;
+
+    const float value = effect->getParameter(index);
+    knobValueLabels_[static_cast<size_t>(index)].setText(getParameterMapping(shownEffect_, index).toText(value),
+                                                         juce::dontSendNotification);
+
+    // Sync knob position if it changed externally
+    auto& knob = knobs_[static_cast<size_t>(index)];
+    if (std::abs(static_cast<float>(knob.getValue()) - value) > 0.001f) {
+        knob.setValue(value, juce::dontSendNotification);
+    }
+}
+
 } // namespace incant
@@ -3,6 +3,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
+#include "AnimationScheduler.h"
 
 namespace incant {
 
@@ -19,38 +20,69 @@ private:
 
 //==============================================================================
 // Level meter with magical glow
-class LevelMeter : public juce::Component, public juce::Timer {
+class LevelMeter : public juce::Component, public AnimationScheduler::Client {
 public:
     LevelMeter();
     void paint(juce::Graphics& g) override;
-    void timerCallback() override;
+    bool advanceFrame(double deltaSeconds) override;
     void setLevel(float level);
 
 private:
     float currentLevel_ = 0.0f;
     float targetLevel_ = 0.0f;
     float peakLevel_ = 0.0f;
-    int peakHoldCounter_ = 0;
+    double peakHoldSeconds_ = 0.0;
+};
+
+//==============================================================================
+// Pre/post spectrum, drawn from the analyzers' pre-reduced band levels
+class SpectrumDisplay : public juce::Component, public AnimationScheduler::Client {
+public:
+    SpectrumDisplay(SpectrumAnalyzer& pre, SpectrumAnalyzer& post);
+    ~SpectrumDisplay() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    bool advanceFrame(double deltaSeconds) override;
+
+private:
+    void buildPath(const SpectrumAnalyzer::Bands& bands, juce::Path& path, bool closed) const;
+
+    SpectrumAnalyzer& pre_;
+    SpectrumAnalyzer& post_;
+
+    SpectrumAnalyzer::Bands preBands_{};
+    SpectrumAnalyzer::Bands postBands_{};
+    juce::uint32 preVersion_ = 0;
+    juce::uint32 postVersion_ = 0;
+
+    // Rebuilt only when new levels arrive or the size changes
+    juce::Path prePath_;
+    juce::Path postPath_;
 };
 
 //==============================================================================
 // Main Editor
 class IncantEditor : public juce::AudioProcessorEditor,
-                     public juce::Timer {
+                     public AnimationScheduler::Client {
 public:
     explicit IncantEditor(IncantProcessor& processor);
     ~IncantEditor() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
-    void timerCallback() override;
+    void focusOfChildComponentChanged(FocusChangeType cause) override;
+    bool advanceFrame(double deltaSeconds) override;
 
 private:
     void onCastSpell();
     void onEffectTypeChanged();
     void updateKnobsForEffect();
+    void refreshKnob(int index);
     void drawRuneCircle(juce::Graphics& g, float cx, float cy, float radius);
+    void drawRuneMarks(juce::Graphics& g, float cx, float cy, float radius);
     void drawMysticalBackground(juce::Graphics& g);
+    void renderBackgroundCache(float scale);
 
     IncantProcessor& processor_;
 
@@ -85,15 +117,37 @@ private:
     std::array<juce::Label, NUM_KNOBS> knobLabels_;
     std::array<juce::Label, NUM_KNOBS> knobValueLabels_;
 
+    // Last processor change state the knobs reflect; only knobs whose
+    // parameter version moved are refreshed
+    EffectType shownEffect_ = EffectType::EQ;
+    juce::uint32 shownChangeCount_ = 0;
+    std::array<juce::uint32, NUM_KNOBS> knobVersions_{};
+
     // Meters
     LevelMeter inputMeter_;
     LevelMeter outputMeter_;
     juce::Label inputLabel_;
     juce::Label outputLabel_;
 
+    // Spectrum
+    SpectrumDisplay spectrum_;
+
+    // Static layers (background, glow, noise, rune rings) rendered once at the
+    // display's pixel scale; dropped on resize and re-rendered on scale change
+    juce::Image backgroundCache_;
+    float backgroundCacheScale_ = 0.0f;
+
+    // Only the rotating rune marks animate; this is the area they repaint
+    static constexpr float kRuneRadius = 180.0f;
+    juce::Rectangle<int> runeArea_;
+
     // Animation state
     float backgroundPhase_ = 0.0f;
     bool isGenerating_ = false;
+    int shownLoadPercent_ = -1;     // -1 when no model load is shown
+
+    // Ticks the editor, meters and spectrum; declared last so it goes first
+    AnimationScheduler animator_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IncantEditor)
 };
@@ -1,12 +1,14 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "ParameterMapping.h"
 
 namespace incant {
 
 IncantProcessor::IncantProcessor()
     : AudioProcessor(BusesProperties()
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
-                     .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                     .withInput("Sidechain", juce::AudioChannelSet::stereo(), false))
 {
     eq_ = std::make_unique<Equalizer>();
     compressor_ = std::make_unique<Compressor>();
@@ -19,9 +21,137 @@ IncantProcessor::IncantProcessor()
     phaser_ = std::make_unique<Phaser>();
     tremolo_ = std::make_unique<Tremolo>();
     filter_ = std::make_unique<Filter>();
+
+    createHostParameters();
+    llmEngine_.preloadModel(currentEffect_);
+    startTimer(kApplyIntervalMs);
+}
+
+IncantProcessor::~IncantProcessor() {
+    stopTimer();
+    for (auto& host : hostParameters_) {
+        host->parameter->removeListener(this);
+    }
+}
+
+void IncantProcessor::createHostParameters() {
+    // Every effect's parameters are exposed up front so the host sees a fixed
+    // set; all of them are normalized 0-1 and shown through the same mapping
+    // the effect and the editor use
+    for (int t = 0; t < kNumEffectTypes; ++t) {
+        const auto type = static_cast<EffectType>(t);
+        auto* effect = getEffect(type);
+        if (!effect) continue;
+
+        for (int i = 0; i < effect->getNumParameters(); ++i) {
+            const float value = effect->getParameter(i);
+            const auto& mapping = getParameterMapping(type, i);
+            auto parameter = std::make_unique<juce::AudioParameterFloat>(
+                juce::ParameterID(juce::String(getEffectTypeName(type)) + "_" + juce::String(i), 1),
+                juce::String(getEffectDisplayName(type)) + " " + effect->getParameterName(i),
+                juce::NormalisableRange<float>(0.0f, 1.0f), value,
+                juce::AudioParameterFloatAttributes()
+                    .withStringFromValueFunction([&mapping](float v, int) { return mapping.toText(v); })
+                    .withValueFromStringFunction([&mapping](const juce::String& text) { return mapping.fromText(text); }));
+
+            auto host = std::make_unique<HostParameter>();
+            host->parameter = parameter.get();
+            host->effect = type;
+            host->index = i;
+            host->target.store(value);
+            host->applied = value;
+
+            parameter->addListener(this);
+            addParameter(parameter.release());
+
+            effectHostParameters_[static_cast<size_t>(t)].push_back(host.get());
+            hostParameters_.push_back(std::move(host));
+        }
+    }
+}
+
+IncantProcessor::HostParameter* IncantProcessor::findHostParameter(EffectType type, int index) const {
+    const auto& parameters = effectHostParameters_[static_cast<size_t>(type)];
+    if (index < 0 || index >= static_cast<int>(parameters.size())) return nullptr;
+    return parameters[static_cast<size_t>(index)];
+}
+
+void IncantProcessor::parameterValueChanged(int parameterIndex, float newValue) {
+    // Any thread, often the audio thread during automation playback. Our own
+    // writes come back here with their target and are ignored.
+    if (parameterIndex < 0 || parameterIndex >= static_cast<int>(hostParameters_.size())) return;
+
+    auto& host = *hostParameters_[static_cast<size_t>(parameterIndex)];
+    if (newValue == host.target.load(std::memory_order_acquire)) return;
+
+    // Smoothed parameters ramp from the next block on; the rest follow once
+    // the message thread applies the staged value
+    if (auto* effect = getEffect(host.effect)) {
+        effect->setParameterTarget(host.index, newValue);
+    }
+    stageParameter(host, newValue, false);
+}
+
+void IncantProcessor::stageParameter(HostParameter& host, float value, bool notifyHost) {
+    // Target before flags, so whoever sees the flag sees the value
+    host.target.store(value, std::memory_order_release);
+    if (notifyHost) {
+        host.notifyHost.store(true, std::memory_order_release);
+    }
+    host.pending.store(true, std::memory_order_release);
+    parametersPending_[static_cast<size_t>(host.effect)].store(true, std::memory_order_release);
 }
 
-IncantProcessor::~IncantProcessor() = default;
+void IncantProcessor::applyPendingParameters() {
+    // Message thread only
+    for (int t = 0; t < kNumEffectTypes; ++t) {
+        if (!parametersPending_[static_cast<size_t>(t)].exchange(false, std::memory_order_acq_rel)) continue;
+
+        auto* effect = getEffect(static_cast<EffectType>(t));
+        if (!effect) continue;
+
+        // One batch per effect, so e.g. the EQ designs a single FIR for a
+        // whole model result
+        effect->beginParameterChanges();
+        bool changed = false;
+        for (auto* host : effectHostParameters_[static_cast<size_t>(t)]) {
+            if (!host->pending.exchange(false, std::memory_order_acq_rel)) continue;
+
+            const float value = host->target.load(std::memory_order_acquire);
+            if (value != host->applied) {
+                host->applied = value;
+                effect->setParameter(host->index, value);
+
+                // Value first, then the version, so a reader that sees the new version sees the value
+                if (host->index < kMaxTrackedParameters) {
+                    parameterVersions_[static_cast<size_t>(host->index)].fetch_add(1, std::memory_order_release);
+                }
+                changed = true;
+            }
+
+            // Keep the host in step with our own writes; its automation
+            // already holds the value and must not be echoed back
+            if (host->notifyHost.exchange(false, std::memory_order_acq_rel) && host->parameter->get() != value) {
+                host->parameter->setValueNotifyingHost(value);
+            }
+        }
+
+        effect->endParameterChanges();
+
+        if (changed) {
+            parameterChangeCount_.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+void IncantProcessor::timerCallback() {
+    applyPendingParameters();
+
+    const int latency = effectLatency_.load(std::memory_order_relaxed);
+    if (latency != getLatencySamples()) {
+        setLatencySamples(latency);
+    }
+}
 
 void IncantProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     eq_->prepare(sampleRate, samplesPerBlock);
@@ -35,6 +165,9 @@ void IncantProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     phaser_->prepare(sampleRate, samplesPerBlock);
     tremolo_->prepare(sampleRate, samplesPerBlock);
     filter_->prepare(sampleRate, samplesPerBlock);
+
+    inputAnalyzer_.prepare(sampleRate);
+    outputAnalyzer_.prepare(sampleRate);
 }
 
 void IncantProcessor::releaseResources() {
@@ -51,21 +184,42 @@ void IncantProcessor::releaseResources() {
     filter_->reset();
 }
 
-void IncantProcessor::processBlock(juce::AudioBuffer<float>& buffer,
+bool IncantProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
+    // Main bus: mono or stereo, same layout in and out
+    const auto& mainOut = layouts.getMainOutputChannelSet();
+    if (mainOut != juce::AudioChannelSet::mono() && mainOut != juce::AudioChannelSet::stereo())
+        return false;
+    if (layouts.getMainInputChannelSet() != mainOut)
+        return false;
+
+    // Sidechain: optional, mono or stereo
+    const auto& sidechain = layouts.getChannelSet(true, 1);
+    return sidechain.isDisabled()
+        || sidechain == juce::AudioChannelSet::mono()
+        || sidechain == juce::AudioChannelSet::stereo();
+}
+
+void IncantProcessor::processBlock(juce::AudioBuffer<float>& hostBuffer,
                                    juce::MidiBuffer& /*midiMessages*/) {
     juce::ScopedNoDenormals noDenormals;
 
+    // The host buffer also carries the sidechain channels; both views below
+    // point into it without copying
+    auto buffer = getBusBuffer(hostBuffer, true, 0);
+    auto sidechain = getBusBuffer(hostBuffer, true, 1);
+
     // Calculate input level
     float inLevel = 0.0f;
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
         inLevel = std::max(inLevel, buffer.getRMSLevel(ch, 0, buffer.getNumSamples()));
     }
     inputLevel_ = inLevel;
+    inputAnalyzer_.pushSamples(buffer);
 
     // Process effect
     auto* effect = getCurrentEffect();
     if (effect) {
-        effect->process(buffer);
+        processEffect(*effect, buffer, sidechain);
     }
 
     // Calculate output level
@@ -74,11 +228,28 @@ void IncantProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         outLevel = std::max(outLevel, buffer.getRMSLevel(ch, 0, buffer.getNumSamples()));
     }
     outputLevel_ = outLevel;
+    outputAnalyzer_.pushSamples(buffer);
 
     // Calculate gain reduction (for compressor visualization)
-    if (inLevel > 0.0001f) {
+    if (currentEffect_ == EffectType::Compressor) {
+        gainReduction_ = compressor_->getGainReductionMinDb();
+    } else if (inLevel > 0.0001f) {
         gainReduction_ = juce::Decibels::gainToDecibels(outLevel / inLevel);
     }
+
+    // Latency of what was just processed; the message thread reports
+    // changes, since the host may reconfigure from setLatencySamples()
+    effectLatency_.store(effect ? effect->getLatencySamples() : 0, std::memory_order_relaxed);
+}
+
+void IncantProcessor::processEffect(EffectBase& effect, juce::AudioBuffer<float>& buffer,
+                                    juce::AudioBuffer<float>& sidechain) {
+    // Automation needs nothing here: smoothed parameters already ramp
+    // per sample towards the host's value (see parameterValueChanged)
+    const bool hasSidechain = sidechain.getNumChannels() > 0;
+    effect.setSidechain(hasSidechain ? &sidechain : nullptr);
+    effect.process(buffer);
+    effect.setSidechain(nullptr);
 }
 
 juce::AudioProcessorEditor* IncantProcessor::createEditor() {
@@ -90,11 +261,13 @@ void IncantProcessor::getStateInformation(juce::MemoryBlock& destData) {
 
     xml.setAttribute("effectType", static_cast<int>(currentEffect_));
 
+    // Staged values count, even if the message thread hasn't applied them yet
     auto* effect = getCurrentEffect();
     if (effect) {
         for (int i = 0; i < effect->getNumParameters(); ++i) {
-            xml.setAttribute(juce::String("param") + juce::String(i),
-                           static_cast<double>(effect->getParameter(i)));
+            const auto* host = findHostParameter(currentEffect_, i);
+            const float value = host ? host->target.load(std::memory_order_acquire) : effect->getParameter(i);
+            xml.setAttribute(juce::String("param") + juce::String(i), static_cast<double>(value));
         }
     }
 
@@ -107,30 +280,41 @@ void IncantProcessor::setStateInformation(const void* data, int sizeInBytes) {
     if (xml && xml->hasTagName("IncantState")) {
         setEffectType(static_cast<EffectType>(xml->getIntAttribute("effectType", 0)));
 
-        auto* effect = getCurrentEffect();
-        if (effect) {
-            for (int i = 0; i < effect->getNumParameters(); ++i) {
-                float value = static_cast<float>(
-                    xml->getDoubleAttribute(juce::String("param") + juce::String(i), 0.5));
-                effect->setParameter(i, value);
+        // Sessions saved before a parameter existed load it at its default,
+        // which keeps features added since then (multiband, sidechain,
+        // linear phase, extra bands) switched off
+        auto restored = LLMEngine::getDefaultParams(currentEffect_);
+        std::visit([&xml](auto& p) {
+            for (int i = 0; i < numParameters<std::decay_t<decltype(p)>>(); ++i) {
+                const double fallback = getParameterValue(p, i);
+                setParameterValue(p, i, static_cast<float>(
+                    xml->getDoubleAttribute(juce::String("param") + juce::String(i), fallback)));
             }
-        }
+        }, restored);
+
+        // Staged together, so the EQ designs one FIR for the whole state
+        applyParameters(restored);
     }
 }
 
 void IncantProcessor::setEffectType(EffectType type) {
     currentEffect_ = type;
+    parameterChangeCount_.fetch_add(1, std::memory_order_release);
 }
 
 void IncantProcessor::generateFromText(const std::string& description) {
     llmEngine_.generateParameters(currentEffect_, description,
-        [this](bool /*success*/, const ParameterResult& result) {
+        [this](bool /*success*/, bool /*provisional*/, const ParameterResult& result) {
             applyParameters(result);
         });
 }
 
 EffectBase* IncantProcessor::getCurrentEffect() {
-    switch (currentEffect_) {
+    return getEffect(currentEffect_);
+}
+
+EffectBase* IncantProcessor::getEffect(EffectType type) {
+    switch (type) {
         case EffectType::EQ: return eq_.get();
         case EffectType::Compressor: return compressor_.get();
         case EffectType::Reverb: return reverb_.get();
@@ -164,95 +348,43 @@ const EffectBase* IncantProcessor::getCurrentEffect() const {
 }
 
 void IncantProcessor::applyParameters(const ParameterResult& params) {
-    std::visit([this](auto&& p) {
-        using T = std::decay_t<decltype(p)>;
-
-        if constexpr (std::is_same_v<T, EQParams>) {
-            setEffectParameter(0, p.lowGain);
-            setEffectParameter(1, p.midGain);
-            setEffectParameter(2, p.highGain);
-            setEffectParameter(3, p.airGain);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, CompressorParams>) {
-            setEffectParameter(0, p.threshold);
-            setEffectParameter(1, p.ratio);
-            setEffectParameter(2, p.attack);
-            setEffectParameter(3, p.release);
-            setEffectParameter(4, p.makeup);
-        }
-        else if constexpr (std::is_same_v<T, ReverbParams>) {
-            setEffectParameter(0, p.size);
-            setEffectParameter(1, p.decay);
-            setEffectParameter(2, p.damping);
-            setEffectParameter(3, p.predelay);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, DistortionParams>) {
-            setEffectParameter(0, p.drive);
-            setEffectParameter(1, p.tone);
-            setEffectParameter(2, p.dryWet);
-            setEffectParameter(3, p.curveType);
-        }
-        else if constexpr (std::is_same_v<T, DelayParams>) {
-            setEffectParameter(0, p.time);
-            setEffectParameter(1, p.feedback);
-            setEffectParameter(2, p.filter);
-            setEffectParameter(3, p.pingPong);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, GlitchParams>) {
-            setEffectParameter(0, p.rate);
-            setEffectParameter(1, p.stutter);
-            setEffectParameter(2, p.crush);
-            setEffectParameter(3, p.reverse);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, OverdriveParams>) {
-            setEffectParameter(0, p.drive);
-            setEffectParameter(1, p.tone);
-            setEffectParameter(2, p.level);
-            setEffectParameter(3, p.midBoost);
-            setEffectParameter(4, p.tightness);
-        }
-        else if constexpr (std::is_same_v<T, ChorusParams>) {
-            setEffectParameter(0, p.rate);
-            setEffectParameter(1, p.depth);
-            setEffectParameter(2, p.delay);
-            setEffectParameter(3, p.feedback);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, PhaserParams>) {
-            setEffectParameter(0, p.rate);
-            setEffectParameter(1, p.depth);
-            setEffectParameter(2, p.feedback);
-            setEffectParameter(3, p.stages);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, TremoloParams>) {
-            setEffectParameter(0, p.rate);
-            setEffectParameter(1, p.depth);
-            setEffectParameter(2, p.shape);
-            setEffectParameter(3, p.stereo);
-            setEffectParameter(4, p.dryWet);
-        }
-        else if constexpr (std::is_same_v<T, FilterParams>) {
-            setEffectParameter(0, p.cutoff);
-            setEffectParameter(1, p.resonance);
-            setEffectParameter(2, p.lfoRate);
-            setEffectParameter(3, p.lfoDepth);
-            setEffectParameter(4, p.filterType);
+    // Only values that differ from the latest target are staged, so a result
+    // that moves three of the EQ's 114 parameters stages three, and they
+    // are applied together
+    std::visit([this](const auto& p) {
+        using Params = std::decay_t<decltype(p)>;
+        for (int i = 0; i < numParameters<Params>(); ++i) {
+            auto* host = findHostParameter(currentEffect_, i);
+            const float value = juce::jlimit(0.0f, 1.0f, getParameterValue(p, i));
+            if (host && host->target.load(std::memory_order_acquire) != value) {
+                stageParameter(*host, value, true);
+            }
         }
     }, params);
+
+    if (juce::MessageManager::existsAndIsCurrentThread()) {
+        applyPendingParameters();
+    }
 }
 
 void IncantProcessor::setEffectParameter(int index, float targetValue) {
-    auto* effect = getCurrentEffect();
-    if (effect && index >= 0 && index < effect->getNumParameters()) {
-        effect->setParameter(index, targetValue);
+    auto* host = findHostParameter(currentEffect_, index);
+    if (!host) return;
+
+    stageParameter(*host, juce::jlimit(0.0f, 1.0f, targetValue), true);
+
+    // The editor and presets see their change straight away; the model's
+    // worker leaves it to the timer
+    if (juce::MessageManager::existsAndIsCurrentThread()) {
+        applyPendingParameters();
     }
 }
 
+juce::uint32 IncantProcessor::getParameterVersion(int index) const {
+    if (index < 0 || index >= kMaxTrackedParameters) return 0;
+    return parameterVersions_[static_cast<size_t>(index)].load(std::memory_order_acquire);
+}
+
 } // namespace incant
 
 // Create plugin instances
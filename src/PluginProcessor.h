@@ -1,9 +1,10 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
-#include "ParameterSchema.h"
+#include "ParameterDescriptors.h"
 #include "LLMEngine.h"
 #include "PresetManager.h"
+#include "SpectrumAnalyzer.h"
 #include "effects/Equalizer.h"
 #include "effects/Compressor.h"
 #include "effects/Reverb.h"
@@ -15,12 +16,16 @@
 #include "effects/Phaser.h"
 #include "effects/Tremolo.h"
 #include "effects/Filter.h"
+#include <array>
 #include <memory>
+#include <vector>
 #include <atomic>
 
 namespace incant {
 
-class IncantProcessor : public juce::AudioProcessor {
+class IncantProcessor : public juce::AudioProcessor,
+                        private juce::AudioProcessorParameter::Listener,
+                        private juce::Timer {
 public:
     IncantProcessor();
     ~IncantProcessor() override;
@@ -28,6 +33,7 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -53,24 +59,66 @@ public:
     // Generation
     void generateFromText(const std::string& description);
     LLMEngine::Status getLLMStatus() const { return llmEngine_.getStatus(); }
+    float getLLMLoadProgress() const { return llmEngine_.getLoadProgress(); }
+    void setEditorFocused(bool focused) { llmEngine_.setFocused(focused); }
 
     // Current effect's parameters
     EffectBase* getCurrentEffect();
     const EffectBase* getCurrentEffect() const;
+    EffectBase* getEffect(EffectType type);
 
-    // Apply generated parameters
+    // Apply generated parameters. Any thread: values are staged and reach
+    // the effect on the message thread, at once when called from there.
     void applyParameters(const ParameterResult& params);
     void setEffectParameter(int index, float targetValue);
 
+    // Change notification for the editor. setEffectType() and every value
+    // that reaches an effect bump the change count, and each changed
+    // parameter's version; safe to read from any thread.
+    static constexpr int kMaxTrackedParameters = 128;
+    juce::uint32 getParameterChangeCount() const { return parameterChangeCount_.load(std::memory_order_acquire); }
+    juce::uint32 getParameterVersion(int index) const;
+
     // Metering
     float getInputLevel() const { return inputLevel_.load(); }
     float getOutputLevel() const { return outputLevel_.load(); }
     float getGainReduction() const { return gainReduction_.load(); }
+    SpectrumAnalyzer& getInputAnalyzer() { return inputAnalyzer_; }
+    SpectrumAnalyzer& getOutputAnalyzer() { return outputAnalyzer_; }
 
     // Preset management
     PresetManager& getPresetManager() { return presetManager_; }
 
 private:
+    // One host parameter per effect parameter, IDs "<effect>_<index>".
+    //
+    // Every write (editor, presets, the model, host automation) lands in
+    // "target" and flags the parameter; only the message thread passes
+    // targets on to the effect, so setParameter() never runs concurrently
+    // with itself or on the audio thread.
+    struct HostParameter {
+        juce::AudioParameterFloat* parameter = nullptr;
+        EffectType effect = EffectType::EQ;
+        int index = 0;
+        std::atomic<float> target{0.0f};      // latest value from any source
+        std::atomic<bool> pending{false};     // target not yet applied
+        std::atomic<bool> notifyHost{false};  // the write came from us, not the host
+        float applied = 0.0f;                 // message thread: value the effect has
+    };
+
+    // How often staged values from other threads reach the effects
+    static constexpr int kApplyIntervalMs = 20;
+
+    void createHostParameters();
+    HostParameter* findHostParameter(EffectType type, int index) const;
+    void stageParameter(HostParameter& host, float value, bool notifyHost);
+    void applyPendingParameters();
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+    void timerCallback() override;
+    void processEffect(EffectBase& effect, juce::AudioBuffer<float>& buffer,
+                       juce::AudioBuffer<float>& sidechain);
+
     EffectType currentEffect_ = EffectType::Reverb;
 
     std::unique_ptr<Equalizer> eq_;
@@ -85,6 +133,14 @@ private:
     std::unique_ptr<Tremolo> tremolo_;
     std::unique_ptr<Filter> filter_;
 
+    std::vector<std::unique_ptr<HostParameter>> hostParameters_;        // by host index
+    std::array<std::vector<HostParameter*>, kNumEffectTypes> effectHostParameters_;
+    std::array<std::atomic<bool>, kNumEffectTypes> parametersPending_{};
+    std::atomic<int> effectLatency_{0};   // set by the audio thread, reported by the timer
+
+    std::array<std::atomic<juce::uint32>, kMaxTrackedParameters> parameterVersions_{};
+    std::atomic<juce::uint32> parameterChangeCount_{0};
+
     LLMEngine llmEngine_;
     PresetManager presetManager_;
 
@@ -92,6 +148,8 @@ private:
     std::atomic<float> inputLevel_{0.0f};
     std::atomic<float> outputLevel_{0.0f};
     std::atomic<float> gainReduction_{0.0f};
+    SpectrumAnalyzer inputAnalyzer_;
+    SpectrumAnalyzer outputAnalyzer_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IncantProcessor)
 };
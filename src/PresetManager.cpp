@@ -102,7 +102,7 @@ void PresetManager::loadPreset(const Preset& preset, IncantProcessor& processor)
     auto* effect = processor.getCurrentEffect();
     if (effect) {
         for (size_t i = 0; i < preset.parameters.size() && i < static_cast<size_t>(effect->getNumParameters()); ++i) {
-            effect->setParameter(static_cast<int>(i), preset.parameters[i]);
+            processor.setEffectParameter(static_cast<int>(i), preset.parameters[i]);
         }
     }
 }
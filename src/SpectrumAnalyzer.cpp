@@ -0,0 +1,187 @@
+#include "SpectrumAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace incant {
+
+namespace {
+
+constexpr float kMinFrequency = 20.0f;
+constexpr float kMaxFrequency = 20000.0f;
+
+// Per-hop smoothing: rises quickly, falls slowly so peaks stay readable
+constexpr float kRiseAmount = 0.8f;
+constexpr float kFallAmount = 0.25f;
+constexpr float kSettledDb = 0.05f;
+
+// Never more than this much backlog is analysed after the thread was starved
+constexpr int kMaxBacklog = SpectrumAnalyzer::kFftSize;
+
+} // namespace
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : fifoBuffer_(static_cast<size_t>(kFifoSize), 0.0f),
+      window_(static_cast<size_t>(kFftSize), 0.0f),
+      history_(static_cast<size_t>(kFftSize), 0.0f),
+      fftBuffer_(static_cast<size_t>(kFftSize * 2), 0.0f)
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(
+        window_.data(), static_cast<size_t>(kFftSize), juce::dsp::WindowingFunction<float>::hann, false);
+
+    // Full-scale sine reads 0dB: undo the window's coherent gain and the one-sided spectrum
+    float windowSum = 0.0f;
+    for (float w : window_) windowSum += w;
+    magnitudeScale_ = windowSum > 0.0f ? 2.0f / windowSum : 1.0f;
+
+    smoothed_.fill(kMinDb);
+    published_.fill(kMinDb);
+
+    thread_->addTimeSliceClient(this);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    // Waits for a slice in progress on this client to finish
+    thread_->removeTimeSliceClient(this);
+}
+
+void SpectrumAnalyzer::prepare(double sampleRate) {
+    // The band table belongs to the analysis thread, which rebuilds it on change
+    sampleRate_.store(sampleRate);
+}
+
+void SpectrumAnalyzer::setActive(bool active) {
+    active_.store(active);
+    if (active) thread_->moveToFrontOfQueue(this);
+}
+
+void SpectrumAnalyzer::pushSamples(const juce::AudioBuffer<float>& buffer) {
+    if (!active_.load(std::memory_order_relaxed)) return;
+
+    const int numChannels = std::min(buffer.getNumChannels(), 2);
+    if (numChannels == 0) return;
+
+    const float* left = buffer.getReadPointer(0);
+    const float* right = buffer.getReadPointer(numChannels - 1);
+    const int numSamples = std::min(buffer.getNumSamples(), fifo_.getFreeSpace());
+
+    // Mono sum straight into the FIFO's two regions, no scratch needed
+    int start1, size1, start2, size2;
+    fifo_.prepareToWrite(numSamples, start1, size1, start2, size2);
+    for (int i = 0; i < size1; ++i) {
+        fifoBuffer_[static_cast<size_t>(start1 + i)] = 0.5f * (left[i] + right[i]);
+    }
+    for (int i = 0; i < size2; ++i) {
+        fifoBuffer_[static_cast<size_t>(start2 + i)] = 0.5f * (left[size1 + i] + right[size1 + i]);
+    }
+    fifo_.finishedWrite(size1 + size2);
+}
+
+bool SpectrumAnalyzer::getBands(Bands& bands, juce::uint32& lastVersion) const {
+    const juce::SpinLock::ScopedLockType lock(publishLock_);
+    if (version_ == lastVersion) return false;
+
+    bands = published_;
+    lastVersion = version_;
+    return true;
+}
+
+int SpectrumAnalyzer::useTimeSlice() {
+    if (!active_.load()) {
+        // Start over from silence next time the editor opens
+        hopFill_ = 0;
+        return 100;
+    }
+
+    const double sampleRate = sampleRate_.load();
+    if (sampleRate != tableSampleRate_) {
+        updateBandTable(sampleRate);
+    }
+
+    // After a stall, skip to the most recent audio instead of catching up
+    const int backlog = fifo_.getNumReady() - kMaxBacklog;
+    if (backlog > 0) {
+        int start1, size1, start2, size2;
+        fifo_.prepareToRead(backlog, start1, size1, start2, size2);
+        fifo_.finishedRead(size1 + size2);
+    }
+
+    while (fifo_.getNumReady() > 0) {
+        const int wanted = std::min(fifo_.getNumReady(), kHopSize - hopFill_);
+
+        // New samples fill the last hop of the history
+        int start1, size1, start2, size2;
+        fifo_.prepareToRead(wanted, start1, size1, start2, size2);
+        float* dest = history_.data() + (kFftSize - kHopSize + hopFill_);
+        std::copy_n(fifoBuffer_.data() + start1, size1, dest);
+        std::copy_n(fifoBuffer_.data() + start2, size2, dest + size1);
+        fifo_.finishedRead(size1 + size2);
+
+        hopFill_ += size1 + size2;
+        if (hopFill_ == kHopSize) {
+            analyseFrame();
+            std::copy(history_.begin() + kHopSize, history_.end(), history_.begin());
+            hopFill_ = 0;
+        }
+    }
+
+    // Roughly one hop at 48kHz
+    return 10;
+}
+
+void SpectrumAnalyzer::updateBandTable(double sampleRate) {
+    tableSampleRate_ = sampleRate;
+    const float binsPerHz = static_cast<float>(kFftSize / sampleRate);
+    const int maxBin = kFftSize / 2;
+
+    for (int b = 0; b <= kNumBands; ++b) {
+        const float proportion = static_cast<float>(b) / static_cast<float>(kNumBands);
+        const float frequency = kMinFrequency * std::pow(kMaxFrequency / kMinFrequency, proportion);
+        bandEdges_[static_cast<size_t>(b)] = juce::jlimit(0, maxBin, static_cast<int>(std::round(frequency * binsPerHz)));
+    }
+    for (int b = 0; b < kNumBands; ++b) {
+        const float proportion = (static_cast<float>(b) + 0.5f) / static_cast<float>(kNumBands);
+        const float frequency = kMinFrequency * std::pow(kMaxFrequency / kMinFrequency, proportion);
+        bandCentres_[static_cast<size_t>(b)] = juce::jlimit(0.0f, static_cast<float>(maxBin - 1), frequency * binsPerHz);
+    }
+
+    smoothed_.fill(kMinDb);
+}
+
+void SpectrumAnalyzer::analyseFrame() {
+    std::transform(history_.begin(), history_.end(), window_.begin(), fftBuffer_.begin(),
+                   std::multiplies<float>());
+    std::fill(fftBuffer_.begin() + kFftSize, fftBuffer_.end(), 0.0f);
+    fft_.performFrequencyOnlyForwardTransform(fftBuffer_.data(), true);
+
+    for (int b = 0; b < kNumBands; ++b) {
+        const int first = bandEdges_[static_cast<size_t>(b)];
+        const int last = bandEdges_[static_cast<size_t>(b + 1)];
+
+        // Wide (high) bands take their loudest bin; bands narrower than a bin
+        // (low end) interpolate between the two bins around their centre
+        float magnitude = 0.0f;
+        if (last - first >= 2) {
+            magnitude = *std::max_element(fftBuffer_.begin() + first, fftBuffer_.begin() + last);
+        } else {
+            const float centre = bandCentres_[static_cast<size_t>(b)];
+            const int bin = static_cast<int>(centre);
+            const float frac = centre - static_cast<float>(bin);
+            magnitude = fftBuffer_[static_cast<size_t>(bin)]
+                        + frac * (fftBuffer_[static_cast<size_t>(bin + 1)] - fftBuffer_[static_cast<size_t>(bin)]);
+        }
+
+        const float levelDb = juce::Decibels::gainToDecibels(magnitude * magnitudeScale_, kMinDb);
+        float& level = smoothed_[static_cast<size_t>(b)];
+        level += (levelDb - level) * (levelDb > level ? kRiseAmount : kFallAmount);
+        if (std::abs(levelDb - level) < kSettledDb) level = levelDb;
+    }
+
+    // A settled spectrum (e.g. silence) publishes nothing, so the editor can idle
+    const juce::SpinLock::ScopedLockType lock(publishLock_);
+    if (published_ == smoothed_) return;
+    published_ = smoothed_;
+    ++version_;
+}
+
+} // namespace incant
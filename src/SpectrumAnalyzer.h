@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace incant {
+
+// Spectrum of one signal tap (pre or post effect) for the editor.
+//
+// The audio thread only mixes the block to mono into a lock-free FIFO, and
+// only while an editor is showing the analyzer. A background thread shared by
+// every plugin instance drains the FIFO, runs Hann-windowed FFTs with 75%
+// overlap and reduces each one to kNumBands log-spaced levels with peak-hold
+// style smoothing. The editor just reads those few values.
+class SpectrumAnalyzer : private juce::TimeSliceClient {
+public:
+    static constexpr int kFftOrder = 11;
+    static constexpr int kFftSize = 1 << kFftOrder;
+    static constexpr int kHopSize = kFftSize / 4;
+    static constexpr int kNumBands = 96;           // 20Hz to 20kHz, log spaced
+    static constexpr float kMinDb = -90.0f;
+
+    using Bands = std::array<float, kNumBands>;
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    void prepare(double sampleRate);
+
+    // Audio thread: never blocks; samples that don't fit are dropped
+    void pushSamples(const juce::AudioBuffer<float>& buffer);
+
+    // Editor: analysis (and the audio-thread copy) only run while active
+    void setActive(bool active);
+
+    // GUI thread: copies the latest levels in dB if they changed since
+    // lastVersion, and updates lastVersion
+    bool getBands(Bands& bands, juce::uint32& lastVersion) const;
+
+private:
+    // One low-priority thread serves the analyzers of all instances
+    struct AnalyzerThread : public juce::TimeSliceThread {
+        AnalyzerThread() : juce::TimeSliceThread("Incant Spectrum") {
+            startThread(juce::Thread::Priority::low);
+        }
+        ~AnalyzerThread() override { stopThread(1000); }
+    };
+
+    static constexpr int kFifoSize = kFftSize * 4;
+
+    int useTimeSlice() override;
+    void analyseFrame();
+    void updateBandTable(double sampleRate);
+
+    juce::SharedResourcePointer<AnalyzerThread> thread_;
+
+    // Audio thread -> analysis thread
+    juce::AbstractFifo fifo_{kFifoSize};
+    std::vector<float> fifoBuffer_;
+    std::atomic<bool> active_{false};
+    std::atomic<double> sampleRate_{44100.0};
+
+    // Analysis thread only
+    juce::dsp::FFT fft_{kFftOrder};
+    std::vector<float> window_;
+    std::vector<float> history_;
+    std::vector<float> fftBuffer_;
+    int hopFill_ = 0;
+    double tableSampleRate_ = 0.0;
+    std::array<int, kNumBands + 1> bandEdges_{};    // FFT bin at each band edge
+    std::array<float, kNumBands> bandCentres_{};    // fractional bin, for narrow bands
+    float magnitudeScale_ = 1.0f;
+    Bands smoothed_{};
+
+    // Analysis thread -> GUI; neither side is real-time
+    juce::SpinLock publishLock_;
+    Bands published_{};
+    juce::uint32 version_ = 0;
+};
+
+} // namespace incant
@@ -0,0 +1,184 @@
+#include "BiquadCascade.h"
+
+namespace incant {
+
+namespace {
+
+// Working copy of the cascade for one block. Increments are zero for
+// sections that are not ramping.
+template <typename Stereo, size_t N>
+struct CascadeRegisters {
+    std::array<Stereo, N> b0, b1, b2, a1, a2;
+    std::array<Stereo, N> db0, db1, db2, da1, da2;
+    std::array<Stereo, N> s1, s2;
+};
+
+template <bool Ramp, typename Stereo, size_t N>
+void runCascade(CascadeRegisters<Stereo, N>& r, size_t sections,
+                float* left, float* right, int numSamples) {
+    alignas(16) double frame[2] = {0.0, 0.0};
+
+    for (int i = 0; i < numSamples; ++i) {
+        frame[0] = static_cast<double>(left[i]);
+        frame[1] = right != nullptr ? static_cast<double>(right[i]) : 0.0;
+        auto v = Stereo::fromRawArray(frame);
+
+        for (size_t k = 0; k < sections; ++k) {
+            const auto y = r.b0[k] * v + r.s1[k];
+            r.s1[k] = r.b1[k] * v - r.a1[k] * y + r.s2[k];
+            r.s2[k] = r.b2[k] * v - r.a2[k] * y;
+            v = y;
+        }
+
+        if constexpr (Ramp) {
+            for (size_t k = 0; k < sections; ++k) {
+                r.b0[k] += r.db0[k];
+                r.b1[k] += r.db1[k];
+                r.b2[k] += r.db2[k];
+                r.a1[k] += r.da1[k];
+                r.a2[k] += r.da2[k];
+            }
+        }
+
+        v.copyToRawArray(frame);
+        left[i] = static_cast<float>(frame[0]);
+        if (right != nullptr) right[i] = static_cast<float>(frame[1]);
+    }
+}
+
+} // namespace
+
+void BiquadCascade::reset() {
+    for (auto& s : state_) {
+        s = State{};
+    }
+
+    // Jump straight to the latest coefficients
+    takePendingCoefficients();
+    current_ = target_;
+    ramping_ = 0;
+    lastActive_ = 0;
+}
+
+void BiquadCascade::setSection(int index, const Coefficients& coefficients) {
+    if (index < 0 || index >= kMaxSections) return;
+
+    const juce::SpinLock::ScopedLockType lock(pendingLock_);
+    pending_[static_cast<size_t>(index)] = coefficients;
+    pendingDirty_ |= (1u << index);
+}
+
+void BiquadCascade::setSection(int index, const std::array<double, 6>& c) {
+    setSection(index, Coefficients::fromArray(c));
+}
+
+void BiquadCascade::rampSection(int index, const std::array<double, 6>& c) {
+    if (index < 0 || index >= kMaxSections) return;
+
+    target_[static_cast<size_t>(index)] = Coefficients::fromArray(c);
+    ramping_ |= (1u << index);
+}
+
+void BiquadCascade::takePendingCoefficients() {
+    // Never wait on the message thread; a busy lock just defers to the next block
+    const juce::SpinLock::ScopedTryLockType lock(pendingLock_);
+    if (!lock.isLocked() || pendingDirty_ == 0) return;
+
+    for (int k = 0; k < kMaxSections; ++k) {
+        const juce::uint32 bit = 1u << k;
+        if ((pendingDirty_ & bit) != 0) {
+            // A section already mid-ramp restarts from where it got to
+            target_[static_cast<size_t>(k)] = pending_[static_cast<size_t>(k)];
+            ramping_ |= bit;
+        }
+    }
+    pendingDirty_ = 0;
+}
+
+void BiquadCascade::process(juce::AudioBuffer<float>& buffer, juce::uint32 activeSections) {
+    takePendingCoefficients();
+
+    activeSections &= (1u << kMaxSections) - 1u;
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = std::min(buffer.getNumChannels(), 2);
+    if (activeSections == 0 || numSamples == 0 || numChannels == 0) {
+        lastActive_ = activeSections;
+        return;
+    }
+
+    // Sections switched on since the last block start from silence at their
+    // target response instead of from stale state
+    const juce::uint32 switchedOn = activeSections & ~lastActive_;
+    lastActive_ = activeSections;
+
+    // Compact the active sections so the per-sample loop has no gaps
+    std::array<size_t, kMaxSections> order{};
+    size_t numActive = 0;
+    for (int k = 0; k < kMaxSections; ++k) {
+        const juce::uint32 bit = 1u << k;
+        if ((activeSections & bit) == 0) continue;
+
+        const auto index = static_cast<size_t>(k);
+        if ((switchedOn & bit) != 0) {
+            state_[index] = State{};
+            current_[index] = target_[index];
+            ramping_ &= ~bit;
+        }
+        order[numActive++] = index;
+    }
+
+    const bool ramp = (ramping_ & activeSections) != 0;
+    const double rampScale = 1.0 / static_cast<double>(numSamples);
+
+    CascadeRegisters<Stereo, kMaxSections> r;
+    for (size_t n = 0; n < numActive; ++n) {
+        const size_t k = order[n];
+        const auto& c = current_[k];
+        r.b0[n] = Stereo::expand(c.b0);
+        r.b1[n] = Stereo::expand(c.b1);
+        r.b2[n] = Stereo::expand(c.b2);
+        r.a1[n] = Stereo::expand(c.a1);
+        r.a2[n] = Stereo::expand(c.a2);
+
+        // Linear ramp over this block; the stability triangle is convex, so
+        // every intermediate set between two stable sections is stable too
+        const bool sectionRamps = (ramping_ & (1u << k)) != 0;
+        const auto& t = sectionRamps ? target_[k] : c;
+        r.db0[n] = Stereo::expand((t.b0 - c.b0) * rampScale);
+        r.db1[n] = Stereo::expand((t.b1 - c.b1) * rampScale);
+        r.db2[n] = Stereo::expand((t.b2 - c.b2) * rampScale);
+        r.da1[n] = Stereo::expand((t.a1 - c.a1) * rampScale);
+        r.da2[n] = Stereo::expand((t.a2 - c.a2) * rampScale);
+
+        r.s1[n] = Stereo::fromRawArray(state_[k].s1);
+        r.s2[n] = Stereo::fromRawArray(state_[k].s2);
+    }
+
+    float* left = buffer.getWritePointer(0);
+    float* right = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+
+    if (ramp) {
+        runCascade<true>(r, numActive, left, right, numSamples);
+    } else {
+        runCascade<false>(r, numActive, left, right, numSamples);
+    }
+
+    for (size_t n = 0; n < numActive; ++n) {
+        const size_t k = order[n];
+        r.s1[n].copyToRawArray(state_[k].s1);
+        r.s2[n].copyToRawArray(state_[k].s2);
+    }
+
+    // Ramps finish at the end of the block; land exactly on the targets
+    if (ramp) {
+        for (size_t n = 0; n < numActive; ++n) {
+            const size_t k = order[n];
+            if ((ramping_ & (1u << k)) != 0) {
+                current_[k] = target_[k];
+            }
+        }
+        ramping_ &= ~activeSections;
+    }
+}
+
+} // namespace incant
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+namespace incant {
+
+// Series chain of biquad sections run in a single pass per sample, with the
+// two stereo channels in the lanes of a double-precision SIMD register.
+// Only the sections in the active mask are loaded and run, so disabled
+// sections cost nothing.
+//
+// Coefficients are staged per section from the message thread into a
+// preallocated pending set. At the start of each block the audio thread takes
+// the changed sections (if it can get the lock without waiting) and ramps
+// from the old to the new coefficients over that block.
+class BiquadCascade {
+public:
+    static constexpr int kMaxSections = 16;
+
+    struct Coefficients {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+        // ArrayCoefficients are normalised: {b0, b1, b2, 1, a1, a2}
+        static Coefficients fromArray(const std::array<double, 6>& c) {
+            return {c[0], c[1], c[2], c[4], c[5]};
+        }
+    };
+
+    BiquadCascade() = default;
+
+    void reset();
+
+    // Message thread: stage one section, picked up at the next block
+    void setSection(int index, const Coefficients& coefficients);
+    void setSection(int index, const std::array<double, 6>& arrayCoefficients);
+
+    // Audio thread: ramp one section to new coefficients over the next process() call
+    void rampSection(int index, const std::array<double, 6>& arrayCoefficients);
+
+    // Audio thread: filters the first two channels in place through the
+    // sections whose bits are set in activeSections, in index order
+    void process(juce::AudioBuffer<float>& buffer, juce::uint32 activeSections);
+
+private:
+    using Stereo = juce::dsp::SIMDRegister<double>;
+    static_assert(Stereo::SIMDNumElements == 2, "one channel per SIMD lane");
+
+    void takePendingCoefficients();
+
+    // Message-thread side of the double buffer, guarded by pendingLock_
+    juce::SpinLock pendingLock_;
+    std::array<Coefficients, kMaxSections> pending_{};
+    juce::uint32 pendingDirty_ = 0;
+
+    // Audio-thread side: coefficients in use and the ramp targets
+    std::array<Coefficients, kMaxSections> current_{};
+    std::array<Coefficients, kMaxSections> target_{};
+    juce::uint32 ramping_ = 0;
+    juce::uint32 lastActive_ = 0;
+
+    // Transposed direct form II state, [section][channel]
+    struct State {
+        alignas(16) double s1[2] = {0.0, 0.0};
+        alignas(16) double s2[2] = {0.0, 0.0};
+    };
+    std::array<State, kMaxSections> state_{};
+};
+
+} // namespace incant
@@ -4,6 +4,10 @@
 namespace incant {
 
 Chorus::Chorus() {
+    setSmoothing(0, Ramp::Linear, 50.0f, params_.rate);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.depth);
+    setSmoothing(2, Ramp::Linear, 50.0f, params_.delay);
+    setSmoothing(3, Ramp::Linear, 50.0f, params_.feedback);
 }
 
 void Chorus::prepare(double sampleRate, int samplesPerBlock) {
@@ -18,6 +22,10 @@ void Chorus::prepare(double sampleRate, int samplesPerBlock) {
 
     lfoPhaseL_ = 0.0f;
     lfoPhaseR_ = 0.25f;
+
+    prepareSmoothing(sampleRate);
+    mixer_.prepare(sampleRate, samplesPerBlock);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 void Chorus::process(juce::AudioBuffer<float>& buffer) {
@@ -28,78 +36,90 @@ void Chorus::process(juce::AudioBuffer<float>& buffer) {
     if (delayBufferSize == 0)
         return;
 
-    // LFO rate: 0.1 to 5 Hz
-    float lfoFreq = 0.1f + params_.rate * 4.9f;
-    float lfoIncrement = lfoFreq / static_cast<float>(sampleRate_);
+    const float samplesPerMs = static_cast<float>(sampleRate_) / 1000.0f;
 
-    // Base delay: 5ms to 30ms
-    float baseDelayMs = 5.0f + params_.delay * 25.0f;
-    float baseDelaySamples = baseDelayMs * static_cast<float>(sampleRate_) / 1000.0f;
+    mixer_.pushDrySamples(buffer);
 
-    // Modulation depth in samples (0.5ms to 5ms)
-    float modDepthMs = 0.5f + params_.depth * 4.5f;
-    float modDepthSamples = modDepthMs * static_cast<float>(sampleRate_) / 1000.0f;
+    processSmoothed(numSamples, [&](int start, int count) {
+        // LFO rate: 0.1 to 5 Hz, at control rate; the rest ramps per sample
+        const float lfoIncrement = (0.1f + smoothedValue(0) * 4.9f) / static_cast<float>(sampleRate_);
+        const float* depthRamp = smoothedRamp(1);
+        const float* delayRamp = smoothedRamp(2);
+        const float* feedbackRamp = smoothedRamp(3);
+        const float steadyDepth = smoothedValue(1);
+        const float steadyDelay = smoothedValue(2);
+        const float steadyFeedback = smoothedValue(3);
 
-    float feedback = params_.feedback * 0.7f;  // Limit feedback
-    float dryWet = params_.dryWet;
+        for (int sample = start; sample < start + count; ++sample) {
+            const int i = sample - start;
 
-    for (int sample = 0; sample < numSamples; ++sample) {
-        // Calculate LFO values (sine wave)
-        float lfoL = std::sin(lfoPhaseL_ * 2.0f * juce::MathConstants<float>::pi);
-        float lfoR = std::sin(lfoPhaseR_ * 2.0f * juce::MathConstants<float>::pi);
+            // Base delay: 5ms to 30ms
+            const float delay = delayRamp != nullptr ? delayRamp[i] : steadyDelay;
+            const float baseDelaySamples = (5.0f + delay * 25.0f) * samplesPerMs;
 
-        // Calculate delay times with modulation
-        float delayL = baseDelaySamples + lfoL * modDepthSamples;
-        float delayR = baseDelaySamples + lfoR * modDepthSamples;
+            // Modulation depth in samples (0.5ms to 5ms)
+            const float depth = depthRamp != nullptr ? depthRamp[i] : steadyDepth;
+            const float modDepthSamples = (0.5f + depth * 4.5f) * samplesPerMs;
 
-        // Clamp delay times
-        delayL = juce::jlimit(1.0f, static_cast<float>(delayBufferSize - 1), delayL);
-        delayR = juce::jlimit(1.0f, static_cast<float>(delayBufferSize - 1), delayR);
+            // Limit feedback
+            const float feedback = (feedbackRamp != nullptr ? feedbackRamp[i] : steadyFeedback) * 0.7f;
 
-        // Linear interpolation for smooth modulation
-        auto readInterpolated = [&](int channel, float delaySamples) {
-            float readPosFloat = static_cast<float>(writePosition_) - delaySamples;
-            if (readPosFloat < 0) readPosFloat += delayBufferSize;
+            // Calculate LFO values (sine wave)
+            float lfoL = std::sin(lfoPhaseL_ * 2.0f * juce::MathConstants<float>::pi);
+            float lfoR = std::sin(lfoPhaseR_ * 2.0f * juce::MathConstants<float>::pi);
 
-            int readPos0 = static_cast<int>(readPosFloat);
-            int readPos1 = (readPos0 + 1) % delayBufferSize;
-            float frac = readPosFloat - std::floor(readPosFloat);
+            // Calculate delay times with modulation
+            float delayL = baseDelaySamples + lfoL * modDepthSamples;
+            float delayR = baseDelaySamples + lfoR * modDepthSamples;
 
-            float s0 = delayBuffer_.getSample(channel, readPos0);
-            float s1 = delayBuffer_.getSample(channel, readPos1);
+            // Clamp delay times
+            delayL = juce::jlimit(1.0f, static_cast<float>(delayBufferSize - 1), delayL);
+            delayR = juce::jlimit(1.0f, static_cast<float>(delayBufferSize - 1), delayR);
 
-            return s0 + frac * (s1 - s0);
-        };
+            // Linear interpolation for smooth modulation
+            auto readInterpolated = [&](int channel, float delaySamples) {
+                float readPosFloat = static_cast<float>(writePosition_) - delaySamples;
+                if (readPosFloat < 0) readPosFloat += delayBufferSize;
 
-        // Get input samples
-        float inputL = buffer.getSample(0, sample);
-        float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
+                int readPos0 = static_cast<int>(readPosFloat);
+                int readPos1 = (readPos0 + 1) % delayBufferSize;
+                float frac = readPosFloat - std::floor(readPosFloat);
 
-        // Read delayed samples
-        float delayedL = readInterpolated(0, delayL);
-        float delayedR = readInterpolated(1, delayR);
+                float s0 = delayBuffer_.getSample(channel, readPos0);
+                float s1 = delayBuffer_.getSample(channel, readPos1);
 
-        // Write to delay buffer with feedback
-        delayBuffer_.setSample(0, writePosition_, inputL + delayedL * feedback);
-        delayBuffer_.setSample(1, writePosition_, inputR + delayedR * feedback);
+                return s0 + frac * (s1 - s0);
+            };
 
-        // Mix dry/wet
-        float outL = inputL * (1.0f - dryWet) + delayedL * dryWet;
-        float outR = inputR * (1.0f - dryWet) + delayedR * dryWet;
+            // Get input samples
+            float inputL = buffer.getSample(0, sample);
+            float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
 
-        buffer.setSample(0, sample, outL);
-        if (numChannels > 1)
-            buffer.setSample(1, sample, outR);
+            // Read delayed samples
+            float delayedL = readInterpolated(0, delayL);
+            float delayedR = readInterpolated(1, delayR);
 
-        // Advance write position
-        writePosition_ = (writePosition_ + 1) % delayBufferSize;
+            // Write to delay buffer with feedback
+            delayBuffer_.setSample(0, writePosition_, inputL + delayedL * feedback);
+            delayBuffer_.setSample(1, writePosition_, inputR + delayedR * feedback);
 
-        // Advance LFO phases
-        lfoPhaseL_ += lfoIncrement;
-        lfoPhaseR_ += lfoIncrement;
-        if (lfoPhaseL_ >= 1.0f) lfoPhaseL_ -= 1.0f;
-        if (lfoPhaseR_ >= 1.0f) lfoPhaseR_ -= 1.0f;
-    }
+            // Wet only; the mixer blends in the dry signal afterwards
+            buffer.setSample(0, sample, delayedL);
+            if (numChannels > 1)
+                buffer.setSample(1, sample, delayedR);
+
+            // Advance write position
+            writePosition_ = (writePosition_ + 1) % delayBufferSize;
+
+            // Advance LFO phases
+            lfoPhaseL_ += lfoIncrement;
+            lfoPhaseR_ += lfoIncrement;
+            if (lfoPhaseL_ >= 1.0f) lfoPhaseL_ -= 1.0f;
+            if (lfoPhaseR_ >= 1.0f) lfoPhaseR_ -= 1.0f;
+        }
+    });
+
+    mixer_.mixWetSamples(buffer);
 }
 
 void Chorus::reset() {
@@ -107,39 +127,33 @@ void Chorus::reset() {
     writePosition_ = 0;
     lfoPhaseL_ = 0.0f;
     lfoPhaseR_ = 0.25f;
+    mixer_.reset();
+    snapSmoothing();
 }
 
 void Chorus::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.rate = value; break;
-        case 1: params_.depth = value; break;
-        case 2: params_.delay = value; break;
-        case 3: params_.feedback = value; break;
-        case 4: params_.dryWet = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
+
+    setSmoothingTarget(index, value);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 float Chorus::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.rate;
-        case 1: return params_.depth;
-        case 2: return params_.delay;
-        case 3: return params_.feedback;
-        case 4: return params_.dryWet;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Chorus::getParameterName(int index) const {
-    static const char* names[] = {"Rate", "Depth", "Delay", "Feedback", "Dry/Wet"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<ChorusParams>(index);
 }
 
 void Chorus::setParams(const ChorusParams& params) {
     params_ = params;
+    for (int i = 0; i < getNumParameters(); ++i) {
+        setSmoothingTarget(i, getParameter(i));
+    }
+    mixer_.setWetMix(params_.dryWet);
 }
 
 } // namespace incant
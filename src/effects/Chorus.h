@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterDescriptors.h"
 
 namespace incant {
 
@@ -16,7 +17,7 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<ChorusParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const ChorusParams& params);
@@ -31,6 +32,8 @@ private:
     // LFO phase (separate for stereo spread)
     float lfoPhaseL_ = 0.0f;
     float lfoPhaseR_ = 0.25f;  // 90 degree offset for stereo
+
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
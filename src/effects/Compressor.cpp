@@ -1,95 +1,432 @@
 #include "Compressor.h"
+#include "FastMath.h"
 
 namespace incant {
 
-Compressor::Compressor() = default;
+namespace {
+
+// Soft knee (Giannoulis et al.), written so one expression covers below,
+// inside and above the knee:
+//   gr = slope * (k^2 / 2W + max(over - W/2, 0)),  k = clamp(over + W/2, 0, W)
+inline float gainReductionDb(float levelDb, float thresholdDb, float slope,
+                             float halfKnee, float invTwoKnee) {
+    const float over = levelDb - thresholdDb;
+    const float k = juce::jlimit(0.0f, 2.0f * halfKnee, over + halfKnee);
+    return slope * (k * k * invTwoKnee + std::max(over - halfKnee, 0.0f));
+}
+
+// Band parameters: threshold, ratio and gain for each band from index 13
+constexpr int kFirstBandParameter = 13;
+constexpr int kParametersPerBand = 3;
+
+static_assert(numParameters<CompressorParams>() == Compressor::kNumParameters, "compressor table size");
+static_assert(CrossoverBank::kNumBands == std::tuple_size<decltype(CompressorParams::bands)>::value,
+              "one set of band parameters per crossover band");
+
+} // namespace
+
+Compressor::Compressor() {
+    // Everything the gain computer reads ramps, so threshold, ratio, knee and
+    // gain moves don't step the output level. Attack, release, lookahead and
+    // the crossovers change no gain directly and apply at once.
+    setSmoothing(0, Ramp::Linear, 50.0f, params_.threshold);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.ratio);
+    setSmoothing(4, Ramp::Linear, 50.0f, params_.makeup);
+    setSmoothing(5, Ramp::Linear, 50.0f, params_.knee);
+    setSmoothing(8, Ramp::Linear, 50.0f, params_.link);
+    for (int b = 0; b < kNumBands; ++b) {
+        const int first = kFirstBandParameter + b * kParametersPerBand;
+        for (int field = 0; field < kParametersPerBand; ++field) {
+            setSmoothing(first + field, Ramp::Linear, 50.0f, getParameter(first + field));
+        }
+    }
+}
 
 void Compressor::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
     blockSize_ = samplesPerBlock;
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = 2;
+    // Scratch holds one frame of kNumBands values per sample so the single
+    // and multiband paths can share it
+    maxChunk_ = std::max(samplesPerBlock, 1);
+    gainBuffer_.setSize(kMaxChannels, maxChunk_ * kNumBands);
+    bandBuffer_.setSize(kMaxChannels, maxChunk_ * kNumBands);
 
-    compressor_.prepare(spec);
-    makeupGain_.prepare(spec);
+    const int maxLookahead = static_cast<int>(std::ceil(sampleRate * kMaxLookaheadMs * 0.001));
+    lookaheadFrames_ = maxLookahead + maxChunk_;
+    lookaheadBuffer_.setSize(kMaxChannels, lookaheadFrames_ * kNumBands);
 
+    crossover_.prepare(sampleRate);
+    keyCrossover_.prepare(sampleRate);
+    keyBandBuffer_.setSize(kMaxChannels, maxChunk_ * kNumBands);
+
+    prepareSmoothing(sampleRate);
     updateCompressor();
+    reset();
 }
 
 void Compressor::process(juce::AudioBuffer<float>& buffer) {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = std::min(buffer.getNumChannels(), kMaxChannels);
+    if (numChannels == 0 || maxChunk_ == 0) return;
+
+    // A mode switch starts the new layout from silence before its first chunk
+    const bool multiband = multiband_.load();
+    if (multiband != historyMultiband_) {
+        clearModeHistory();
+        historyMultiband_ = multiband;
+    }
+
+    float minGainDb = 0.0f;
+    double sumGainDb = 0.0;
+
+    // Hosts may send more than the prepared block size; work in chunks so the
+    // scratch buffers never need to grow on the audio thread
+    processSmoothed(numSamples, [&](int start, int count) {
+        for (int offset = start; offset < start + count; offset += maxChunk_) {
+            const int chunk = std::min(maxChunk_, start + count - offset);
+            if (multiband) {
+                processMultibandChunk(buffer, offset, chunk, numChannels, minGainDb, sumGainDb);
+            } else {
+                processChunk(buffer, offset, chunk, numChannels, minGainDb, sumGainDb);
+            }
+        }
+    });
+
+    // Published values exclude makeup gain
+    const int totalGains = numSamples * numChannels * (multiband ? kNumBands : 1);
+    gainReductionMin_.store(minGainDb, std::memory_order_relaxed);
+    gainReductionAvg_.store(totalGains > 0 ? static_cast<float>(sumGainDb / totalGains) : 0.0f,
+                            std::memory_order_relaxed);
+}
+
+void Compressor::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                              int numChannels, float& minGainDb, double& sumGainDb) {
+    // The detector reads the key directly from the host's sidechain channels
+    const auto* key = activeSidechain();
+    std::array<const float*, kMaxChannels> input{};
+    for (int ch = 0; ch < numChannels; ++ch) {
+        input[static_cast<size_t>(ch)] = key != nullptr
+            ? key->getReadPointer(std::min(ch, key->getNumChannels() - 1), startSample)
+            : buffer.getReadPointer(ch, startSample);
+    }
+
+    detectEnvelope(input.data(), numSamples, numChannels);
+    computeGains(numSamples, numChannels, minGainDb, sumGainDb);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* data = buffer.getWritePointer(ch, startSample);
+        delayForLookahead(data, ch, numSamples, 1);
+        juce::FloatVectorOperations::multiply(data, gainBuffer_.getReadPointer(ch), numSamples);
+    }
+
+    lookaheadWritePos_ = (lookaheadWritePos_ + numSamples) % lookaheadFrames_;
+}
+
+void Compressor::processMultibandChunk(juce::AudioBuffer<float>& buffer, int startSample,
+                                       int numSamples, int numChannels,
+                                       float& minGainDb, double& sumGainDb) {
+    using Lanes = CrossoverBank::Lanes;
+
+    // With a key, bands are detected on the key's own split
+    const auto* key = activeSidechain();
+    std::array<const float*, kMaxChannels> detectBands{};
+    for (int ch = 0; ch < numChannels; ++ch) {
+        crossover_.process(ch, buffer.getReadPointer(ch, startSample),
+                           bandBuffer_.getWritePointer(ch), numSamples);
+        if (key != nullptr) {
+            keyCrossover_.process(ch, key->getReadPointer(std::min(ch, key->getNumChannels() - 1),
+                                                          startSample),
+                                  keyBandBuffer_.getWritePointer(ch), numSamples);
+        }
+        detectBands[static_cast<size_t>(ch)] = key != nullptr ? keyBandBuffer_.getReadPointer(ch)
+                                                              : bandBuffer_.getReadPointer(ch);
+    }
+
+    detectBandEnvelopes(detectBands.data(), numSamples, numChannels);
+    computeBandGains(numSamples, numChannels, minGainDb, sumGainDb);
+
+    // Apply each band's gain to the delayed band frames and sum them back
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* frames = bandBuffer_.getWritePointer(ch);
+        delayForLookahead(frames, ch, numSamples, kNumBands);
+
+        const float* gains = gainBuffer_.getReadPointer(ch);
+        float* out = buffer.getWritePointer(ch, startSample);
+        for (int i = 0; i < numSamples; ++i) {
+            const auto band = Lanes::fromRawArray(frames + i * kNumBands);
+            const auto gain = Lanes::fromRawArray(gains + i * kNumBands);
+            out[i] = (band * gain).sum();
+        }
+    }
 
-    compressor_.process(context);
-    makeupGain_.process(context);
+    lookaheadWritePos_ = (lookaheadWritePos_ + numSamples) % lookaheadFrames_;
+}
+
+void Compressor::detectEnvelope(const float* const* input, int numSamples, int numChannels) {
+    // Serial part: the ballistics filter carries state from sample to sample.
+    // Levels are written to gainBuffer_ and turned into gains by computeGains().
+    const float link = numChannels > 1 ? link_ : 0.0f;
+    const float attack = attackCoeff_;
+    const float release = releaseCoeff_;
+
+    for (int i = 0; i < numSamples; ++i) {
+        std::array<float, kMaxChannels> detect{};
+        float linked = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float x = input[ch][i];
+            const float d = rmsDetector_ ? x * x : std::abs(x);
+            detect[static_cast<size_t>(ch)] = d;
+            linked = std::max(linked, d);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const auto c = static_cast<size_t>(ch);
+            const float d = detect[c] + link * (linked - detect[c]);
+            float& env = envelope_[c];
+            const float coeff = d > env ? attack : release;
+            env = d + coeff * (env - d);
+            gainBuffer_.setSample(ch, i, env);
+        }
+    }
+}
+
+void Compressor::detectBandEnvelopes(const float* const* bandFrames, int numSamples,
+                                     int numChannels) {
+    // Same ballistics as detectEnvelope(), with the four bands in SIMD lanes.
+    // The attack/release choice is made branch-free by splitting the step into
+    // its rising and falling parts.
+    using Lanes = CrossoverBank::Lanes;
+
+    const auto zero = Lanes::expand(0.0f);
+    const auto attackStep = Lanes::expand(1.0f - attackCoeff_);
+    const auto releaseStep = Lanes::expand(1.0f - releaseCoeff_);
+    const auto link = Lanes::expand(numChannels > 1 ? link_ : 0.0f);
+    const bool rms = rmsDetector_;
+
+    std::array<Lanes, kMaxChannels> env;
+    std::array<const float*, kMaxChannels> bands{};
+    std::array<float*, kMaxChannels> levels{};
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const auto c = static_cast<size_t>(ch);
+        env[c] = Lanes::fromRawArray(bandEnvelope_[c]);
+        bands[c] = bandFrames[c];
+        levels[c] = gainBuffer_.getWritePointer(ch);
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        std::array<Lanes, kMaxChannels> detect;
+        auto linked = zero;
+        for (size_t c = 0; c < static_cast<size_t>(numChannels); ++c) {
+            const auto x = Lanes::fromRawArray(bands[c] + i * kNumBands);
+            detect[c] = rms ? x * x : Lanes::max(x, zero - x);
+            linked = Lanes::max(linked, detect[c]);
+        }
+
+        for (size_t c = 0; c < static_cast<size_t>(numChannels); ++c) {
+            const auto d = detect[c] + link * (linked - detect[c]);
+            const auto delta = d - env[c];
+            env[c] += attackStep * Lanes::max(delta, zero) + releaseStep * Lanes::min(delta, zero);
+            env[c].copyToRawArray(levels[c] + i * kNumBands);
+        }
+    }
+
+    for (size_t c = 0; c < static_cast<size_t>(numChannels); ++c) {
+        env[c].copyToRawArray(bandEnvelope_[c]);
+    }
+}
+
+const juce::AudioBuffer<float>* Compressor::activeSidechain() const {
+    if (!useSidechain_ || sidechain_ == nullptr || sidechain_->getNumChannels() == 0) {
+        return nullptr;
+    }
+    return sidechain_;
+}
+
+void Compressor::computeGains(int numSamples, int numChannels, float& minGainDb, double& sumGainDb) {
+    const float threshold = thresholdDb_;
+    const float slope = slope_;
+    const float halfKnee = kneeDb_ * 0.5f;
+    const float invTwoKnee = kneeDb_ > 0.0f ? 1.0f / (2.0f * kneeDb_) : 0.0f;
+    const float makeupDb = makeupDb_;
+    // RMS envelopes hold mean squares; halve the log to get the RMS level
+    const float levelScale = rmsDetector_ ? kDbPerLog2 * 0.5f : kDbPerLog2;
+    constexpr float kFloor = 1.0e-9f;
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* g = gainBuffer_.getWritePointer(ch);
+        float chunkMin = 0.0f;
+        float chunkSum = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i) {
+            const float levelDb = levelScale * fastLog2(std::max(g[i], kFloor));
+            const float grDb = gainReductionDb(levelDb, threshold, slope, halfKnee, invTwoKnee);
+
+            chunkMin = std::min(chunkMin, grDb);
+            chunkSum += grDb;
+            g[i] = fastExp2((grDb + makeupDb) * (1.0f / kDbPerLog2));
+        }
+
+        minGainDb = std::min(minGainDb, chunkMin);
+        sumGainDb += static_cast<double>(chunkSum);
+    }
+}
+
+void Compressor::computeBandGains(int numSamples, int numChannels, float& minGainDb, double& sumGainDb) {
+    // Per-band thresholds, slopes and output gains; the fixed-width inner loop
+    // maps onto one SIMD register per sample
+    const auto thresholds = bandThresholdDb_;
+    const auto slopes = bandSlope_;
+    const auto outputGains = bandOutputDb_;
+    const float halfKnee = kneeDb_ * 0.5f;
+    const float invTwoKnee = kneeDb_ > 0.0f ? 1.0f / (2.0f * kneeDb_) : 0.0f;
+    const float levelScale = rmsDetector_ ? kDbPerLog2 * 0.5f : kDbPerLog2;
+    constexpr float kFloor = 1.0e-9f;
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* g = gainBuffer_.getWritePointer(ch);
+        float chunkMin = 0.0f;
+        float chunkSum = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i) {
+            float* frame = g + i * kNumBands;
+            for (size_t b = 0; b < static_cast<size_t>(kNumBands); ++b) {
+                const float levelDb = levelScale * fastLog2(std::max(frame[b], kFloor));
+                const float grDb = gainReductionDb(levelDb, thresholds[b], slopes[b],
+                                                   halfKnee, invTwoKnee);
+                chunkMin = std::min(chunkMin, grDb);
+                chunkSum += grDb;
+                frame[b] = fastExp2((grDb + outputGains[b]) * (1.0f / kDbPerLog2));
+            }
+        }
+
+        minGainDb = std::min(minGainDb, chunkMin);
+        sumGainDb += static_cast<double>(chunkSum);
+    }
+}
+
+void Compressor::delayForLookahead(float* data, int channel, int numFrames, int frameSize) {
+    // The ring is written even with zero lookahead so enabling it later
+    // starts from real history instead of stale samples. Switching between
+    // single and multiband changes its frame layout, so that clears it.
+    const int ringFrames = lookaheadFrames_;
+    float* ring = lookaheadBuffer_.getWritePointer(channel);
+
+    const int writeFirst = std::min(numFrames, ringFrames - lookaheadWritePos_);
+    juce::FloatVectorOperations::copy(ring + lookaheadWritePos_ * frameSize, data,
+                                      writeFirst * frameSize);
+    juce::FloatVectorOperations::copy(ring, data + writeFirst * frameSize,
+                                      (numFrames - writeFirst) * frameSize);
+
+    if (lookaheadSamples_ == 0) return;
+
+    const int readPos = (lookaheadWritePos_ - lookaheadSamples_ + ringFrames) % ringFrames;
+    const int readFirst = std::min(numFrames, ringFrames - readPos);
+    juce::FloatVectorOperations::copy(data, ring + readPos * frameSize, readFirst * frameSize);
+    juce::FloatVectorOperations::copy(data + readFirst * frameSize, ring,
+                                      (numFrames - readFirst) * frameSize);
+}
+
+void Compressor::clearModeHistory() {
+    // The ring holds frames of the previous mode's size and the detectors
+    // and crossovers hold its envelopes; neither means anything in the new one
+    envelope_.fill(0.0f);
+    for (auto& env : bandEnvelope_) {
+        std::fill(std::begin(env), std::end(env), 0.0f);
+    }
+    crossover_.reset();
+    keyCrossover_.reset();
+    lookaheadBuffer_.clear();
+    lookaheadWritePos_ = 0;
 }
 
 void Compressor::reset() {
-    compressor_.reset();
-    makeupGain_.reset();
+    historyMultiband_ = multiband_.load();
+    clearModeHistory();
+    gainBuffer_.clear();
+    bandBuffer_.clear();
+    keyBandBuffer_.clear();
+    gainReductionMin_.store(0.0f, std::memory_order_relaxed);
+    gainReductionAvg_.store(0.0f, std::memory_order_relaxed);
+    snapSmoothing();
+    updateGainComputer();
 }
 
 void Compressor::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.threshold = value; break;
-        case 1: params_.ratio = value; break;
-        case 2: params_.attack = value; break;
-        case 3: params_.release = value; break;
-        case 4: params_.makeup = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
 
+    setSmoothingTarget(index, value);
     updateCompressor();
 }
 
 float Compressor::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.threshold;
-        case 1: return params_.ratio;
-        case 2: return params_.attack;
-        case 3: return params_.release;
-        case 4: return params_.makeup;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Compressor::getParameterName(int index) const {
-    static const char* names[] = {"Threshold", "Ratio", "Attack", "Release", "Makeup"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<CompressorParams>(index);
 }
 
 void Compressor::setParams(const CompressorParams& params) {
     params_ = params;
+    for (int i = 0; i < kNumParameters; ++i) {
+        setSmoothingTarget(i, getParameter(i));
+    }
     updateCompressor();
 }
 
 void Compressor::updateCompressor() {
-    // Convert normalized values to actual values
-    // Threshold: 0-1 maps to -60dB to 0dB
-    float thresholdDB = params_.threshold * 60.0f - 60.0f;
+    // Convert normalized values to actual values, through the same curves
+    // the editor labels use (ranges are in ParameterDescriptors.h)
+    const auto physical = [this](int index) {
+        return parameterCurve<CompressorParams>(index).toPhysical(getParameter(index));
+    };
 
-    // Ratio: 0-1 maps to 1:1 to 20:1
-    float ratio = 1.0f + params_.ratio * 19.0f;
+    float attackMs = physical(2);
+    float releaseMs = physical(3);
+    float lookaheadMs = physical(6);
 
-    // Attack: 0-1 maps to 0.1ms to 100ms
-    float attackMs = 0.1f + params_.attack * 99.9f;
+    attackCoeff_ = envelopeCoefficient(attackMs, sampleRate_);
+    releaseCoeff_ = envelopeCoefficient(releaseMs, sampleRate_);
+    rmsDetector_ = params_.detector >= 0.5f;
 
-    // Release: 0-1 maps to 10ms to 1000ms
-    float releaseMs = 10.0f + params_.release * 990.0f;
+    const int maxLookahead = std::max(lookaheadFrames_ - maxChunk_, 0);
+    lookaheadSamples_ = juce::jlimit(0, maxLookahead,
+                                     static_cast<int>(std::round(lookaheadMs * 0.001 * sampleRate_)));
 
-    // Makeup: 0-1 maps to 0dB to 24dB
-    float makeupDB = params_.makeup * 24.0f;
+    // Multiband: crossovers are spaced on log scales
+    // Low: 40-400Hz, Mid: 200-2000Hz, High: 2-16kHz
+    multiband_ = params_.multiband >= 0.5f;
+    useSidechain_ = params_.sidechain >= 0.5f;
+    const float lowHz = physical(10);
+    const float midHz = physical(11);
+    const float highHz = physical(12);
+    crossover_.setCrossoverFrequencies(lowHz, midHz, highHz);
+    keyCrossover_.setCrossoverFrequencies(lowHz, midHz, highHz);
+}
+
+void Compressor::updateGainComputer() {
+    // Audio thread (and prepare): once per control block while ramping
+    const auto physical = [this](int index) {
+        return parameterCurve<CompressorParams>(index).toPhysical(smoothedValue(index));
+    };
 
-    compressor_.setThreshold(thresholdDB);
-    compressor_.setRatio(ratio);
-    compressor_.setAttack(attackMs);
-    compressor_.setRelease(releaseMs);
-    makeupGain_.setGainDecibels(makeupDB);
+    const float makeupDB = physical(4);
+    thresholdDb_ = physical(0);
+    slope_ = 1.0f / physical(1) - 1.0f;
+    kneeDb_ = physical(5);
+    makeupDb_ = makeupDB;
+    link_ = smoothedValue(8);
+
+    // Band threshold and ratio use the main mappings; band gain is -12dB to +12dB
+    for (size_t b = 0; b < static_cast<size_t>(kNumBands); ++b) {
+        const int first = kFirstBandParameter + static_cast<int>(b) * kParametersPerBand;
+        bandThresholdDb_[b] = physical(first);
+        bandSlope_[b] = 1.0f / physical(first + 1) - 1.0f;
+        bandOutputDb_[b] = physical(first + 2) + makeupDB;
+    }
 }
 
 } // namespace incant
@@ -1,12 +1,26 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "CrossoverBank.h"
+#include "../ParameterMapping.h"
+#include <atomic>
 
 namespace incant {
 
+// Feed-forward compressor with lookahead, peak/RMS detection, soft knee and
+// stereo linking. Each block runs in three passes: a serial envelope detector,
+// a branchless gain computer over the whole block, then gain application to
+// the lookahead-delayed audio.
+//
+// In multiband mode the input is split by a four-band LR4 crossover and the
+// same three passes run on all bands at once, one band per SIMD lane.
+//
+// With the Sidechain parameter on, the detector keys from the processor's
+// sidechain bus instead of the input.
 class Compressor : public EffectBase {
 public:
+    static constexpr int kNumParameters = numParameters<CompressorParams>();
+
     Compressor();
     ~Compressor() override = default;
 
@@ -16,17 +30,80 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return kNumParameters; }
     const char* getParameterName(int index) const override;
+    int getLatencySamples() const override { return lookaheadSamples_; }
 
     void setParams(const CompressorParams& params);
 
+    // Gain reduction of the last processed block in dB (<= 0), safe from any thread
+    float getGainReductionMinDb() const { return gainReductionMin_.load(std::memory_order_relaxed); }
+    float getGainReductionAvgDb() const { return gainReductionAvg_.load(std::memory_order_relaxed); }
+
 private:
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kNumBands = CrossoverBank::kNumBands;
+    static constexpr float kMaxLookaheadMs = 10.0f;
+
+    void smoothedParametersChanged() override { updateGainComputer(); }
+
     void updateCompressor();
+    void updateGainComputer();
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                      int numChannels, float& minGainDb, double& sumGainDb);
+    void processMultibandChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                               int numChannels, float& minGainDb, double& sumGainDb);
+    void detectEnvelope(const float* const* input, int numSamples, int numChannels);
+    void detectBandEnvelopes(const float* const* bandFrames, int numSamples, int numChannels);
+    const juce::AudioBuffer<float>* activeSidechain() const;
+    void computeGains(int numSamples, int numChannels, float& minGainDb, double& sumGainDb);
+    void computeBandGains(int numSamples, int numChannels, float& minGainDb, double& sumGainDb);
+    void delayForLookahead(float* data, int channel, int numFrames, int frameSize);
+    void clearModeHistory();
 
     CompressorParams params_;
-    juce::dsp::Compressor<float> compressor_;
-    juce::dsp::Gain<float> makeupGain_;
+
+    // Derived values; the gain computer's follow the smoothers on the audio
+    // thread (updateGainComputer), the rest are refreshed by updateCompressor()
+    float thresholdDb_ = -30.0f;
+    float slope_ = 0.0f;            // 1/ratio - 1
+    float kneeDb_ = 0.0f;
+    float makeupDb_ = 12.0f;
+    float attackCoeff_ = 0.0f;
+    float releaseCoeff_ = 0.0f;
+    float link_ = 0.0f;
+    bool rmsDetector_ = false;
+    std::atomic<bool> multiband_{false};
+    bool useSidechain_ = false;
+    int lookaheadSamples_ = 0;
+    std::array<float, kNumBands> bandThresholdDb_{};
+    std::array<float, kNumBands> bandSlope_{};
+    std::array<float, kNumBands> bandOutputDb_{};  // band gain + makeup
+
+    // Detector state per channel (level, or mean square in RMS mode)
+    std::array<float, kMaxChannels> envelope_{};
+    alignas(16) float bandEnvelope_[kMaxChannels][kNumBands] = {};
+
+    CrossoverBank crossover_;
+    CrossoverBank keyCrossover_;
+
+    // Scratch sized in prepare(): detector levels, then gains in place, and
+    // the split band frames in multiband mode
+    juce::AudioBuffer<float> gainBuffer_;
+    juce::AudioBuffer<float> bandBuffer_;
+    juce::AudioBuffer<float> keyBandBuffer_;
+    int maxChunk_ = 0;
+
+    // Lookahead ring per channel, in frames of 1 (single band) or kNumBands values
+    juce::AudioBuffer<float> lookaheadBuffer_;
+    int lookaheadFrames_ = 0;
+    int lookaheadWritePos_ = 0;
+
+    // Mode the history above was written in, audio thread only
+    bool historyMultiband_ = false;
+
+    std::atomic<float> gainReductionMin_{0.0f};
+    std::atomic<float> gainReductionAvg_{0.0f};
 };
 
 } // namespace incant
@@ -0,0 +1,114 @@
+#include "CrossoverBank.h"
+
+namespace incant {
+
+namespace {
+// Butterworth Q: two cascaded sections give the LR4 response
+constexpr float kButterworthQ = 0.70710678f;
+} // namespace
+
+CrossoverBank::CrossoverBank() {
+    setCrossoverFrequencies(100.0f, 630.0f, 5600.0f);
+}
+
+void CrossoverBank::prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    reset();
+}
+
+void CrossoverBank::reset() {
+    for (auto& channel : state_) {
+        for (auto& s : channel) {
+            std::fill(std::begin(s.s1), std::end(s.s1), 0.0f);
+            std::fill(std::begin(s.s2), std::end(s.s2), 0.0f);
+        }
+    }
+}
+
+void CrossoverBank::setCrossoverFrequencies(float lowHz, float midHz, float highHz) {
+    using Coeffs = juce::dsp::IIR::ArrayCoefficients<float>;
+
+    // Keep the bands at least half an octave apart and below Nyquist
+    const float nyquistLimit = static_cast<float>(sampleRate_) * 0.45f;
+    const float low = juce::jlimit(20.0f, nyquistLimit / 2.0f, lowHz);
+    const float mid = juce::jlimit(low * 1.5f, nyquistLimit / 1.5f, midHz);
+    const float high = juce::jlimit(mid * 1.5f, nyquistLimit, highHz);
+
+    const auto lpMid = Coeffs::makeLowPass(sampleRate_, mid, kButterworthQ);
+    const auto hpMid = Coeffs::makeHighPass(sampleRate_, mid, kButterworthQ);
+    const auto lpLow = Coeffs::makeLowPass(sampleRate_, low, kButterworthQ);
+    const auto hpLow = Coeffs::makeHighPass(sampleRate_, low, kButterworthQ);
+    const auto lpHigh = Coeffs::makeLowPass(sampleRate_, high, kButterworthQ);
+    const auto hpHigh = Coeffs::makeHighPass(sampleRate_, high, kButterworthQ);
+    const auto apLow = Coeffs::makeAllPass(sampleRate_, low, kButterworthQ);
+    const auto apHigh = Coeffs::makeAllPass(sampleRate_, high, kButterworthQ);
+
+    // Stages 0-1: split at the mid crossover (lanes 0-1 low half, 2-3 high half)
+    for (int stage = 0; stage < 2; ++stage) {
+        setLane(stage, 0, lpMid);
+        setLane(stage, 1, lpMid);
+        setLane(stage, 2, hpMid);
+        setLane(stage, 3, hpMid);
+    }
+
+    // Stages 2-3: split each half at its own crossover
+    for (int stage = 2; stage < 4; ++stage) {
+        setLane(stage, 0, lpLow);
+        setLane(stage, 1, hpLow);
+        setLane(stage, 2, lpHigh);
+        setLane(stage, 3, hpHigh);
+    }
+
+    // Stage 4: phase-compensate each half with the other half's allpass
+    setLane(4, 0, apHigh);
+    setLane(4, 1, apHigh);
+    setLane(4, 2, apLow);
+    setLane(4, 3, apLow);
+}
+
+void CrossoverBank::setLane(int stage, int lane, const std::array<float, 6>& coeffs) {
+    // ArrayCoefficients are normalised: {b0, b1, b2, 1, a1, a2}
+    auto& s = stages_[static_cast<size_t>(stage)];
+    s.b0[lane] = coeffs[0];
+    s.b1[lane] = coeffs[1];
+    s.b2[lane] = coeffs[2];
+    s.a1[lane] = coeffs[4];
+    s.a2[lane] = coeffs[5];
+}
+
+void CrossoverBank::process(int channel, const float* input, float* bands, int numSamples) {
+    jassert(channel >= 0 && channel < kMaxChannels);
+    auto& state = state_[static_cast<size_t>(channel)];
+
+    std::array<Lanes, kNumStages> b0, b1, b2, a1, a2, s1, s2;
+    for (size_t k = 0; k < kNumStages; ++k) {
+        b0[k] = Lanes::fromRawArray(stages_[k].b0);
+        b1[k] = Lanes::fromRawArray(stages_[k].b1);
+        b2[k] = Lanes::fromRawArray(stages_[k].b2);
+        a1[k] = Lanes::fromRawArray(stages_[k].a1);
+        a2[k] = Lanes::fromRawArray(stages_[k].a2);
+        s1[k] = Lanes::fromRawArray(state[k].s1);
+        s2[k] = Lanes::fromRawArray(state[k].s2);
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto v = Lanes::expand(input[i]);
+
+        // Transposed direct form II, all four bands per instruction
+        for (size_t k = 0; k < kNumStages; ++k) {
+            const auto y = b0[k] * v + s1[k];
+            s1[k] = b1[k] * v - a1[k] * y + s2[k];
+            s2[k] = b2[k] * v - a2[k] * y;
+            v = y;
+        }
+
+        v.copyToRawArray(bands + i * kNumBands);
+    }
+
+    for (size_t k = 0; k < kNumStages; ++k) {
+        s1[k].copyToRawArray(state[k].s1);
+        s2[k].copyToRawArray(state[k].s2);
+    }
+}
+
+} // namespace incant
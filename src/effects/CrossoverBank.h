@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+namespace incant {
+
+// Four-band Linkwitz-Riley (LR4) splitter that computes all bands at once,
+// one band per SIMD lane. The tree is split at the mid crossover first, then
+// each half at its own crossover, and each half is finally passed through the
+// other half's allpass so the bands sum back to a flat, phase-coherent signal.
+class CrossoverBank {
+public:
+    static constexpr int kNumBands = 4;
+    static constexpr int kMaxChannels = 2;
+
+    using Lanes = juce::dsp::SIMDRegister<float>;
+    static_assert(Lanes::SIMDNumElements == kNumBands, "one band per SIMD lane");
+
+    CrossoverBank();
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // Crossover frequencies in Hz; re-ordered and clamped to stay valid
+    void setCrossoverFrequencies(float lowHz, float midHz, float highHz);
+
+    // Splits one channel into interleaved band frames: bands[i * kNumBands + band].
+    // bands must be 16-byte aligned.
+    void process(int channel, const float* input, float* bands, int numSamples);
+
+private:
+    static constexpr int kNumStages = 5;
+
+    struct Stage {
+        alignas(16) float b0[kNumBands];
+        alignas(16) float b1[kNumBands];
+        alignas(16) float b2[kNumBands];
+        alignas(16) float a1[kNumBands];
+        alignas(16) float a2[kNumBands];
+    };
+
+    struct State {
+        alignas(16) float s1[kNumBands];
+        alignas(16) float s2[kNumBands];
+    };
+
+    void setLane(int stage, int lane, const std::array<float, 6>& coeffs);
+
+    double sampleRate_ = 44100.0;
+    std::array<Stage, kNumStages> stages_{};
+    std::array<std::array<State, kNumStages>, kMaxChannels> state_{};
+};
+
+} // namespace incant
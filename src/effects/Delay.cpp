@@ -3,8 +3,9 @@
 namespace incant {
 
 Delay::Delay() {
-    smoothedFeedback_.setCurrentAndTargetValue(params_.feedback);
-    smoothedDryWet_.setCurrentAndTargetValue(params_.dryWet);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.feedback);
+    setSmoothing(2, Ramp::Linear, 50.0f, params_.filter);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 void Delay::prepare(double sampleRate, int samplesPerBlock) {
@@ -25,11 +26,11 @@ void Delay::prepare(double sampleRate, int samplesPerBlock) {
 
     feedbackFilter_.prepare(spec);
 
-    // Smoothing for parameter changes (50ms ramp)
-    smoothedFeedback_.reset(sampleRate, 0.05);
-    smoothedDryWet_.reset(sampleRate, 0.05);
+    prepareSmoothing(sampleRate);
+    mixer_.prepare(sampleRate, samplesPerBlock);
 
     updateDelay();
+    updateFeedbackFilter();
 }
 
 void Delay::process(juce::AudioBuffer<float>& buffer) {
@@ -43,47 +44,53 @@ void Delay::process(juce::AudioBuffer<float>& buffer) {
     // Ping-pong factor (0 = mono, 1 = full ping-pong)
     const float pingPong = params_.pingPong;
 
-    for (int sample = 0; sample < numSamples; ++sample) {
-        const float feedback = smoothedFeedback_.getNextValue();
-        const float dryWet = smoothedDryWet_.getNextValue();
+    mixer_.pushDrySamples(buffer);
 
-        // Read position for delay
-        int readPos = (writePosition_ - delaySamples_ + delayBufferSize) % delayBufferSize;
+    processSmoothed(numSamples, [&](int start, int count) {
+        const float* feedbackRamp = smoothedRamp(1);
+        const float steadyFeedback = feedbackGain(smoothedValue(1));
 
-        // Get delayed samples
-        float delayedL = delayBuffer_.getSample(0, readPos);
-        float delayedR = delayBuffer_.getSample(1, readPos);
+        for (int sample = start; sample < start + count; ++sample) {
+            const float feedback = feedbackRamp != nullptr ? feedbackGain(feedbackRamp[sample - start])
+                                                           : steadyFeedback;
 
-        // Apply ping-pong: cross-feed channels
-        float feedbackL = delayedL * (1.0f - pingPong) + delayedR * pingPong;
-        float feedbackR = delayedR * (1.0f - pingPong) + delayedL * pingPong;
+            // Read position for delay
+            int readPos = (writePosition_ - delaySamples_ + delayBufferSize) % delayBufferSize;
 
-        // Get input samples
-        float inputL = buffer.getSample(0, sample);
-        float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
+            // Get delayed samples
+            float delayedL = delayBuffer_.getSample(0, readPos);
+            float delayedR = delayBuffer_.getSample(1, readPos);
 
-        // Write to delay buffer (input + feedback)
-        float writeL = inputL + feedbackL * feedback;
-        float writeR = inputR + feedbackR * feedback;
+            // Apply ping-pong: cross-feed channels
+            float feedbackL = delayedL * (1.0f - pingPong) + delayedR * pingPong;
+            float feedbackR = delayedR * (1.0f - pingPong) + delayedL * pingPong;
 
-        // Soft clip to prevent runaway feedback
-        writeL = std::tanh(writeL);
-        writeR = std::tanh(writeR);
+            // Get input samples
+            float inputL = buffer.getSample(0, sample);
+            float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
 
-        delayBuffer_.setSample(0, writePosition_, writeL);
-        delayBuffer_.setSample(1, writePosition_, writeR);
+            // Write to delay buffer (input + feedback)
+            float writeL = inputL + feedbackL * feedback;
+            float writeR = inputR + feedbackR * feedback;
 
-        // Mix dry/wet
-        float outL = inputL * (1.0f - dryWet) + delayedL * dryWet;
-        float outR = inputR * (1.0f - dryWet) + delayedR * dryWet;
+            // Soft clip to prevent runaway feedback
+            writeL = std::tanh(writeL);
+            writeR = std::tanh(writeR);
 
-        buffer.setSample(0, sample, outL);
-        if (numChannels > 1)
-            buffer.setSample(1, sample, outR);
+            delayBuffer_.setSample(0, writePosition_, writeL);
+            delayBuffer_.setSample(1, writePosition_, writeR);
 
-        // Advance write position
-        writePosition_ = (writePosition_ + 1) % delayBufferSize;
-    }
+            // Wet only; the mixer blends in the dry signal afterwards
+            buffer.setSample(0, sample, delayedL);
+            if (numChannels > 1)
+                buffer.setSample(1, sample, delayedR);
+
+            // Advance write position
+            writePosition_ = (writePosition_ + 1) % delayBufferSize;
+        }
+    });
+
+    mixer_.mixWetSamples(buffer);
 
     // Apply filter to delay buffer feedback (for next iteration)
     // This creates the darkening effect on repeated echoes
@@ -96,43 +103,32 @@ void Delay::reset() {
     delayBuffer_.clear();
     writePosition_ = 0;
     feedbackFilter_.reset();
-    smoothedFeedback_.setCurrentAndTargetValue(params_.feedback);
-    smoothedDryWet_.setCurrentAndTargetValue(params_.dryWet);
+    mixer_.reset();
+    snapSmoothing();
+    updateFeedbackFilter();
 }
 
 void Delay::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.time = value; break;
-        case 1: params_.feedback = value; break;
-        case 2: params_.filter = value; break;
-        case 3: params_.pingPong = value; break;
-        case 4: params_.dryWet = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
 
+    setSmoothingTarget(index, value);
     updateDelay();
 }
 
 float Delay::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.time;
-        case 1: return params_.feedback;
-        case 2: return params_.filter;
-        case 3: return params_.pingPong;
-        case 4: return params_.dryWet;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Delay::getParameterName(int index) const {
-    static const char* names[] = {"Time", "Feedback", "Filter", "PingPong", "Dry/Wet"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<DelayParams>(index);
 }
 
 void Delay::setParams(const DelayParams& params) {
     params_ = params;
+    setSmoothingTarget(1, params_.feedback);
+    setSmoothingTarget(2, params_.filter);
     updateDelay();
 }
 
@@ -142,16 +138,16 @@ void Delay::updateDelay() {
     delaySamples_ = static_cast<int>(delayMs * sampleRate_ / 1000.0);
     delaySamples_ = std::min(delaySamples_, delayBuffer_.getNumSamples() - 1);
 
-    // Update feedback smoother target
-    // Limit feedback to 0.95 to prevent infinite buildup
-    smoothedFeedback_.setTargetValue(params_.feedback * 0.95f);
-    smoothedDryWet_.setTargetValue(params_.dryWet);
+    // Feedback and filter ramp in process()
+    mixer_.setWetMix(params_.dryWet);
+}
 
+void Delay::updateFeedbackFilter() {
     // Filter frequency: 0=500Hz (dark), 1=15kHz (bright)
-    float filterFreq = 500.0f + params_.filter * 14500.0f;
+    float filterFreq = 500.0f + smoothedValue(2) * 14500.0f;
     filterFreq = std::min(filterFreq, static_cast<float>(sampleRate_ * 0.45));
 
-    *feedbackFilter_.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(
+    *feedbackFilter_.state = juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(
         sampleRate_, filterFreq);
 }
 
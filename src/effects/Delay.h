@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterDescriptors.h"
 
 namespace incant {
 
@@ -16,13 +17,19 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<DelayParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const DelayParams& params);
 
 private:
+    void smoothedParametersChanged() override { updateFeedbackFilter(); }
+
+    // Limit feedback to 0.95 to prevent infinite buildup
+    static float feedbackGain(float feedback) { return feedback * 0.95f; }
+
     void updateDelay();
+    void updateFeedbackFilter();
 
     DelayParams params_;
 
@@ -37,9 +44,8 @@ private:
         juce::dsp::IIR::Coefficients<float>
     > feedbackFilter_;
 
-    // Smoothed feedback to avoid clicks
-    juce::SmoothedValue<float> smoothedFeedback_;
-    juce::SmoothedValue<float> smoothedDryWet_;
+    // Dry/wet mixing (smoothed internally)
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
@@ -3,7 +3,10 @@
 
 namespace incant {
 
-Distortion::Distortion() = default;
+Distortion::Distortion() {
+    setSmoothing(0, Ramp::Multiplicative, 50.0f, params_.drive);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.tone);
+}
 
 void Distortion::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
@@ -15,46 +18,46 @@ void Distortion::prepare(double sampleRate, int samplesPerBlock) {
     spec.numChannels = 2;
 
     toneFilter_.prepare(spec);
-    updateFilter();
+    prepareSmoothing(sampleRate);
+    smoothedParametersChanged();
+
+    mixer_.prepare(sampleRate, samplesPerBlock);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 void Distortion::process(juce::AudioBuffer<float>& buffer) {
     const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
 
     // Keep dry signal for mixing
-    juce::AudioBuffer<float> dryBuffer;
-    if (params_.dryWet < 1.0f) {
-        dryBuffer.makeCopyOf(buffer);
-    }
-
-    // Apply drive and distortion
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* data = buffer.getWritePointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            data[i] = processSample(data[i] * driveGain_);
-        }
-    }
+    mixer_.pushDrySamples(buffer);
 
-    // Apply tone filter
     juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    toneFilter_.process(context);
-
-    // Mix dry/wet
-    if (params_.dryWet < 1.0f) {
+    processSmoothed(buffer.getNumSamples(), [&](int start, int count) {
+        // Apply drive and distortion, following the drive ramp per sample
+        const float* drive = smoothedRamp(0);
         for (int ch = 0; ch < numChannels; ++ch) {
-            float* wet = buffer.getWritePointer(ch);
-            const float* dry = dryBuffer.getReadPointer(ch);
-            for (int i = 0; i < numSamples; ++i) {
-                wet[i] = dry[i] * (1.0f - params_.dryWet) + wet[i] * params_.dryWet;
+            float* data = buffer.getWritePointer(ch, start);
+            for (int i = 0; i < count; ++i) {
+                const float gain = drive != nullptr ? driveToGain(drive[i]) : driveGain_;
+                data[i] = processSample(data[i] * gain);
             }
         }
-    }
+
+        // Apply tone filter
+        auto chunk = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(count));
+        juce::dsp::ProcessContextReplacing<float> context(chunk);
+        toneFilter_.process(context);
+    });
+
+    // Mix dry/wet
+    mixer_.mixWetSamples(buffer);
 }
 
 void Distortion::reset() {
     toneFilter_.reset();
+    mixer_.reset();
+    snapSmoothing();
+    smoothedParametersChanged();
 }
 
 float Distortion::processSample(float sample) const {
@@ -88,12 +91,7 @@ float Distortion::processSample(float sample) const {
 void Distortion::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.drive = value; break;
-        case 1: params_.tone = value; break;
-        case 2: params_.dryWet = value; break;
-        case 3: params_.curveType = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
 
     // Update curve type
     if (params_.curveType < 0.25f) {
@@ -106,39 +104,36 @@ void Distortion::setParameter(int index, float value) {
         curveType_ = CurveType::Fuzz;
     }
 
-    // Drive: 0-1 maps to 1x-50x gain
-    driveGain_ = 1.0f + params_.drive * 49.0f;
-
-    updateFilter();
+    // Drive and tone ramp in process()
+    setSmoothingTarget(index, value);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 float Distortion::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.drive;
-        case 1: return params_.tone;
-        case 2: return params_.dryWet;
-        case 3: return params_.curveType;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Distortion::getParameterName(int index) const {
-    static const char* names[] = {"Drive", "Tone", "Dry/Wet", "Type"};
-    if (index >= 0 && index < 4) return names[index];
-    return "";
+    return parameterName<DistortionParams>(index);
 }
 
 void Distortion::setParams(const DistortionParams& params) {
     params_ = params;
+    setParameter(0, params.drive);
+    setParameter(1, params.tone);
     setParameter(3, params.curveType); // Triggers curve type update
+}
+
+void Distortion::smoothedParametersChanged() {
+    driveGain_ = driveToGain(smoothedValue(0));
     updateFilter();
 }
 
 void Distortion::updateFilter() {
     // Tone: 0=dark (1kHz lowpass), 1=bright (12kHz lowpass)
-    float cutoff = 1000.0f + params_.tone * 11000.0f;
+    float cutoff = 1000.0f + smoothedValue(1) * 11000.0f;
 
-    *toneFilter_.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(
+    *toneFilter_.state = juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(
         sampleRate_, cutoff);
 }
 
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterDescriptors.h"
 
 namespace incant {
 
@@ -23,12 +24,17 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 4; }
+    int getNumParameters() const override { return numParameters<DistortionParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const DistortionParams& params);
 
 private:
+    void smoothedParametersChanged() override;
+
+    // Drive: 0-1 maps to 1x-50x gain
+    static float driveToGain(float drive) { return 1.0f + drive * 49.0f; }
+
     float processSample(float sample) const;
     void updateFilter();
 
@@ -39,8 +45,10 @@ private:
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
                                    juce::dsp::IIR::Coefficients<float>> toneFilter_;
 
-    // Oversampling to reduce aliasing (optional, simple version)
+    // Gain at the current (smoothed) drive
     float driveGain_ = 1.0f;
+
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
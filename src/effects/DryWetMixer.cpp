@@ -0,0 +1,155 @@
+#include "DryWetMixer.h"
+#include <cmath>
+
+namespace incant {
+
+void DryWetMixer::prepare(double sampleRate, int maxBlockSize, int numChannels,
+                          int maxLatencySamples) {
+    maxBlockSize = std::max(maxBlockSize, 1);
+    maxLatency_ = std::max(maxLatencySamples, 0);
+
+    dryBuffer_.setSize(numChannels, maxBlockSize);
+    delayLine_.setSize(numChannels, maxLatency_ > 0 ? maxLatency_ + maxBlockSize : 0);
+
+    dryGains_.allocate(static_cast<size_t>(maxBlockSize), true);
+    wetGains_.allocate(static_cast<size_t>(maxBlockSize), true);
+    gainCapacity_ = maxBlockSize;
+
+    // 50ms ramp, same as the Delay's parameter smoothing
+    const float target = mix_.getTargetValue();
+    mix_.reset(sampleRate, 0.05);
+    mix_.setCurrentAndTargetValue(target);
+
+    wetLatency_ = std::min(wetLatency_, maxLatency_);
+    reset();
+}
+
+void DryWetMixer::reset() {
+    dryBuffer_.clear();
+    delayLine_.clear();
+    delayWritePos_ = 0;
+    capturedChannels_ = 0;
+    capturedSamples_ = 0;
+    mix_.setCurrentAndTargetValue(mix_.getTargetValue());
+}
+
+void DryWetMixer::setWetMix(float proportion) {
+    mix_.setTargetValue(juce::jlimit(0.0f, 1.0f, proportion));
+}
+
+void DryWetMixer::setWetLatency(int latencySamples) {
+    latencySamples = juce::jlimit(0, maxLatency_, latencySamples);
+    if (latencySamples != wetLatency_) {
+        wetLatency_ = latencySamples;
+        delayLine_.clear();
+    }
+}
+
+void DryWetMixer::pushDrySamples(const juce::AudioBuffer<float>& buffer) {
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = std::min(buffer.getNumChannels(), dryBuffer_.getNumChannels());
+
+    // Fully wet with nothing to delay: no dry copy needed at all
+    if (wetLatency_ == 0 && !mix_.isSmoothing() && mix_.getTargetValue() >= 1.0f) {
+        capturedSamples_ = 0;
+        return;
+    }
+
+    if (numSamples > dryBuffer_.getNumSamples()) {
+        // Host exceeded the prepared block size; grow once rather than drop the mix
+        jassertfalse;
+        dryBuffer_.setSize(dryBuffer_.getNumChannels(), numSamples, false, false, true);
+        dryGains_.allocate(static_cast<size_t>(numSamples), true);
+        wetGains_.allocate(static_cast<size_t>(numSamples), true);
+        gainCapacity_ = numSamples;
+        if (maxLatency_ > 0) {
+            delayLine_.setSize(delayLine_.getNumChannels(), maxLatency_ + numSamples);
+            delayLine_.clear();
+            delayWritePos_ = 0;
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+        if (wetLatency_ > 0) {
+            delayDryChannel(ch, numSamples);
+        }
+    }
+
+    if (wetLatency_ > 0) {
+        delayWritePos_ = (delayWritePos_ + numSamples) % delayLine_.getNumSamples();
+    }
+
+    capturedChannels_ = numChannels;
+    capturedSamples_ = numSamples;
+}
+
+void DryWetMixer::delayDryChannel(int channel, int numSamples) {
+    const int ringSize = delayLine_.getNumSamples();
+    float* ring = delayLine_.getWritePointer(channel);
+    float* dry = dryBuffer_.getWritePointer(channel);
+
+    // Write the new block, wrapping at most once
+    const int writeFirst = std::min(numSamples, ringSize - delayWritePos_);
+    juce::FloatVectorOperations::copy(ring + delayWritePos_, dry, writeFirst);
+    juce::FloatVectorOperations::copy(ring, dry + writeFirst, numSamples - writeFirst);
+
+    // Read the block that is wetLatency_ samples older
+    const int readPos = (delayWritePos_ - wetLatency_ + ringSize) % ringSize;
+    const int readFirst = std::min(numSamples, ringSize - readPos);
+    juce::FloatVectorOperations::copy(dry, ring + readPos, readFirst);
+    juce::FloatVectorOperations::copy(dry + readFirst, ring, numSamples - readFirst);
+}
+
+void DryWetMixer::computeGains(float mix, float& dryGain, float& wetGain) const {
+    if (rule_ == MixRule::EqualPower) {
+        const float angle = mix * juce::MathConstants<float>::halfPi;
+        dryGain = std::cos(angle);
+        wetGain = std::sin(angle);
+    } else {
+        dryGain = 1.0f - mix;
+        wetGain = mix;
+    }
+}
+
+void DryWetMixer::mixWetSamples(juce::AudioBuffer<float>& buffer) {
+    if (capturedSamples_ == 0) {
+        return;
+    }
+
+    const int numSamples = std::min(buffer.getNumSamples(), capturedSamples_);
+    const int numChannels = std::min(buffer.getNumChannels(), capturedChannels_);
+    capturedSamples_ = 0;
+
+    if (!mix_.isSmoothing()) {
+        float dryGain, wetGain;
+        computeGains(mix_.getTargetValue(), dryGain, wetGain);
+        if (dryGain == 0.0f && wetGain == 1.0f) {
+            return;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* wet = buffer.getWritePointer(ch);
+            juce::FloatVectorOperations::multiply(wet, wetGain, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(wet, dryBuffer_.getReadPointer(ch),
+                                                         dryGain, numSamples);
+        }
+        return;
+    }
+
+    // Ramping: evaluate the gain curves once, then apply them to every channel
+    jassert(numSamples <= gainCapacity_);
+    for (int i = 0; i < numSamples; ++i) {
+        computeGains(mix_.getNextValue(), dryGains_[static_cast<size_t>(i)],
+                     wetGains_[static_cast<size_t>(i)]);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* wet = buffer.getWritePointer(ch);
+        juce::FloatVectorOperations::multiply(wet, wetGains_.getData(), numSamples);
+        juce::FloatVectorOperations::addWithMultiply(wet, dryBuffer_.getReadPointer(ch),
+                                                     dryGains_.getData(), numSamples);
+    }
+}
+
+} // namespace incant
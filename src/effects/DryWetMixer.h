@@ -0,0 +1,59 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace incant {
+
+// Preallocated dry/wet mixer shared by the effects.
+// Usage per block: pushDrySamples() before processing, mixWetSamples() after.
+// The dry path can be delayed to line up with wet-path latency (oversampling,
+// lookahead, linear-phase filters) so the mix never comb-filters.
+class DryWetMixer {
+public:
+    enum class MixRule {
+        Linear,     // dry * (1 - mix) + wet * mix
+        EqualPower  // sin/cos law, constant power for uncorrelated signals
+    };
+
+    DryWetMixer() = default;
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels = 2,
+                 int maxLatencySamples = 0);
+    void reset();
+
+    void setMixRule(MixRule rule) { rule_ = rule; }
+    void setWetMix(float proportion);
+    void setWetLatency(int latencySamples);
+    int getWetLatency() const { return wetLatency_; }
+
+    // Captures (and delays) the dry signal. Call before the effect touches the buffer.
+    void pushDrySamples(const juce::AudioBuffer<float>& buffer);
+
+    // Blends the captured dry signal into the processed buffer in place.
+    void mixWetSamples(juce::AudioBuffer<float>& buffer);
+
+private:
+    void delayDryChannel(int channel, int numSamples);
+    void computeGains(float mix, float& dryGain, float& wetGain) const;
+
+    MixRule rule_ = MixRule::Linear;
+    juce::SmoothedValue<float> mix_{1.0f};
+
+    // Dry copy of the current block
+    juce::AudioBuffer<float> dryBuffer_;
+    int capturedChannels_ = 0;
+    int capturedSamples_ = 0;
+
+    // Latency compensation ring (one per channel)
+    juce::AudioBuffer<float> delayLine_;
+    int delayWritePos_ = 0;
+    int wetLatency_ = 0;
+    int maxLatency_ = 0;
+
+    // Per-sample gains, only filled while the mix is ramping
+    juce::HeapBlock<float> dryGains_;
+    juce::HeapBlock<float> wetGains_;
+    int gainCapacity_ = 0;
+};
+
+} // namespace incant
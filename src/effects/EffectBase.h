@@ -2,6 +2,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "ParameterSmoother.h"
+#include <algorithm>
+#include <array>
 
 namespace incant {
 
@@ -19,9 +22,160 @@ public:
     virtual int getNumParameters() const = 0;
     virtual const char* getParameterName(int index) const = 0;
 
+    // Processing delay introduced by the effect (e.g. lookahead), in samples
+    virtual int getLatencySamples() const { return 0; }
+
+    // Any thread, including the audio thread: starts a smoothed parameter
+    // ramping towards value ahead of the setParameter() call that follows.
+    // Only stores the smoother's atomic target; unsmoothed parameters wait
+    // for setParameter().
+    void setParameterTarget(int index, float value) {
+        setSmoothingTarget(index, juce::jlimit(0.0f, 1.0f, value));
+    }
+
+    // Bracket a run of setParameter() calls (a preset, a model result), so
+    // effects with expensive derived state rebuild it once at the end.
+    // Same thread as setParameter().
+    void beginParameterChanges() { ++parameterChangeDepth_; }
+    void endParameterChanges() {
+        if (--parameterChangeDepth_ == 0) parameterChangesFinished();
+    }
+
+    // External key signal for the next process() call, or nullptr when no
+    // sidechain is connected. The buffer refers to the host's channels and is
+    // only valid for that call.
+    void setSidechain(const juce::AudioBuffer<float>* sidechain) { sidechain_ = sidechain; }
+
 protected:
+    using Ramp = ParameterSmoother::Ramp;
+
+    static constexpr int kMaxSmoothedParameters = 20;   // the multiband compressor needs 17
+    static constexpr int kControlBlockSize = ParameterSmoother::kMaxBlockSize;
+
+    // Per-parameter smoothing. Effects configure their continuous parameters
+    // in the constructor, pass new values to setSmoothingTarget() from
+    // setParameter(), and run their DSP through processSmoothed(). While a
+    // ramp is active the block is split into control blocks; each one first
+    // calls smoothedParametersChanged() so derived coefficients follow the
+    // ramp at control rate. With nothing ramping the whole block runs in one
+    // piece and smoothing costs a single flag check.
+    void setSmoothing(int index, Ramp ramp, float timeMs, float initialValue) {
+        auto* slot = findSmoother(index);
+        if (slot == nullptr) {
+            jassert(numSmoothed_ < kMaxSmoothedParameters);
+            if (numSmoothed_ >= kMaxSmoothedParameters) return;
+            smoothedIndices_[static_cast<size_t>(numSmoothed_)] = index;
+            slot = &smoothers_[static_cast<size_t>(numSmoothed_++)];
+        }
+        slot->configure(ramp, timeMs, initialValue);
+    }
+
+    // From prepare(): converts ramp times and jumps to the targets
+    void prepareSmoothing(double sampleRate) {
+        for (int i = 0; i < numSmoothed_; ++i) smoothers_[static_cast<size_t>(i)].prepare(sampleRate);
+        activeRamps_ = 0;
+    }
+
+    // Any thread; ignored for parameters without smoothing
+    void setSmoothingTarget(int index, float value) {
+        if (auto* smoother = findSmoother(index)) {
+            smoother->setTarget(value);
+            smoothingPending_.store(true);
+        }
+    }
+
+    // From reset(): abandons ramps in progress
+    void snapSmoothing() {
+        for (int i = 0; i < numSmoothed_; ++i) smoothers_[static_cast<size_t>(i)].snapToTarget();
+        activeRamps_ = 0;
+    }
+
+    // Current value of a smoothed parameter (the plain value otherwise)
+    float smoothedValue(int index) const {
+        if (const auto* smoother = findSmoother(index)) return smoother->getCurrentValue();
+        return getParameter(index);
+    }
+
+    // Per-sample values across the current control block, nullptr when steady.
+    // Index the result relative to the block start passed to the chunk.
+    const float* smoothedRamp(int index) const {
+        if (const auto* smoother = findSmoother(index)) return smoother->getRamp();
+        return nullptr;
+    }
+
+    // Recompute coefficients from smoothedValue(); called once per control block while ramping
+    virtual void smoothedParametersChanged() {}
+
+    // Inside beginParameterChanges() / endParameterChanges(); effects may
+    // defer work until parameterChangesFinished()
+    bool isChangingParameters() const { return parameterChangeDepth_ > 0; }
+    virtual void parameterChangesFinished() {}
+
+    // Runs processChunk(startSample, numSamples) over the block
+    template <typename ProcessChunk>
+    void processSmoothed(int numSamples, ProcessChunk&& processChunk) {
+        if (smoothingPending_.exchange(false)) {
+            activeRamps_ = 0;
+            for (int i = 0; i < numSmoothed_; ++i) {
+                if (smoothers_[static_cast<size_t>(i)].beginRamp()) ++activeRamps_;
+            }
+            // Targets too close to ramp still need their coefficients
+            if (activeRamps_ == 0) smoothedParametersChanged();
+        }
+
+        int start = 0;
+        bool ramped = false;
+        while (activeRamps_ > 0 && start < numSamples) {
+            const int count = std::min(kControlBlockSize, numSamples - start);
+            activeRamps_ = 0;
+            for (int i = 0; i < numSmoothed_; ++i) {
+                auto& smoother = smoothers_[static_cast<size_t>(i)];
+                smoother.advance(count);
+                if (smoother.isRamping()) ++activeRamps_;
+            }
+            smoothedParametersChanged();
+            processChunk(start, count);
+            start += count;
+            ramped = true;
+        }
+
+        if (start < numSamples) {
+            if (ramped) {
+                for (int i = 0; i < numSmoothed_; ++i) smoothers_[static_cast<size_t>(i)].advance(0);
+            }
+            processChunk(start, numSamples - start);
+        }
+    }
+
+    // One-pole envelope coefficient, same time constant as juce::dsp::BallisticsFilter
+    static float envelopeCoefficient(float timeMs, double sampleRate) {
+        if (timeMs < 0.001f) return 0.0f;
+        return static_cast<float>(std::exp(-2.0 * juce::MathConstants<double>::pi * 1000.0
+                                           / (sampleRate * static_cast<double>(timeMs))));
+    }
+
     double sampleRate_ = 44100.0;
     int blockSize_ = 512;
+    const juce::AudioBuffer<float>* sidechain_ = nullptr;
+
+private:
+    ParameterSmoother* findSmoother(int index) {
+        for (int i = 0; i < numSmoothed_; ++i) {
+            if (smoothedIndices_[static_cast<size_t>(i)] == index) return &smoothers_[static_cast<size_t>(i)];
+        }
+        return nullptr;
+    }
+
+    const ParameterSmoother* findSmoother(int index) const {
+        return const_cast<EffectBase*>(this)->findSmoother(index);
+    }
+
+    std::array<ParameterSmoother, kMaxSmoothedParameters> smoothers_;
+    std::array<int, kMaxSmoothedParameters> smoothedIndices_{};
+    int numSmoothed_ = 0;
+    int activeRamps_ = 0;
+    int parameterChangeDepth_ = 0;
+    std::atomic<bool> smoothingPending_{false};
 };
 
 } // namespace incant
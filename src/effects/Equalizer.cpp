@@ -2,78 +2,201 @@
 
 namespace incant {
 
+namespace {
+
+// Every band shares the curves of band 1
+const MappingCurve& frequencyCurve() {
+    return parameterCurve<EQParams>(Equalizer::bandParameterIndex(0, Equalizer::BandField::Frequency));
+}
+
+const MappingCurve& qCurve() {
+    return parameterCurve<EQParams>(Equalizer::bandParameterIndex(0, Equalizer::BandField::Q));
+}
+
+const MappingCurve& thresholdCurve() {
+    return parameterCurve<EQParams>(Equalizer::bandParameterIndex(0, Equalizer::BandField::Threshold));
+}
+
+// The descriptor table has to follow the layout documented in Equalizer.h
+static_assert(numParameters<EQParams>() == Equalizer::kNumParameters, "EQ table size");
+static_assert(ParameterTable<EQParams>::parameters[Equalizer::gainParameterIndex(15)].offset
+                  == detail::eqBandOffset(15, offsetof(EQBandParams, gain)), "EQ gain layout");
+static_assert(ParameterTable<EQParams>::parameters[Equalizer::bandParameterIndex(15, Equalizer::BandField::Threshold)].offset
+                  == detail::eqBandOffset(15, offsetof(EQBandParams, threshold)), "EQ band layout");
+
+// Band index owning a parameter, or -1 for dry/wet and linear phase
+int bandForParameter(int index) {
+    if (index >= 0 && index < 4) return index;
+    if (index > 4 && index < Equalizer::kFirstBandField) return index - 1;
+    if (index >= Equalizer::kFirstBandField && index < Equalizer::kLinearPhaseParameter)
+        return (index - Equalizer::kFirstBandField) / Equalizer::kFieldsPerBand;
+    return -1;
+}
+
+} // namespace
+
 Equalizer::Equalizer() = default;
 
 void Equalizer::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
     blockSize_ = samplesPerBlock;
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = 2;
-
-    lowShelf_.prepare(spec);
-    midPeak_.prepare(spec);
-    highPeak_.prepare(spec);
-    airShelf_.prepare(spec);
+    // Dynamic band detectors: 5ms attack, 80ms release
+    detectorAttack_ = envelopeCoefficient(5.0f, sampleRate);
+    detectorRelease_ = envelopeCoefficient(80.0f, sampleRate);
 
+    convolver_.prepare();
     updateFilters();
+    cascade_.reset();
+    detectors_.fill(BandDetector{});
+
+    // The dry path can be delayed to match the linear-phase FIR
+    mixer_.prepare(sampleRate, samplesPerBlock, 2, LinearPhaseConvolver::getLatencySamples());
+    mixer_.setWetMix(params_.dryWet);
+    linearPhaseActive_ = linearPhase_.load(std::memory_order_relaxed);
+    mixer_.setWetLatency(getLatencySamples());
 }
 
 void Equalizer::process(juce::AudioBuffer<float>& buffer) {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    // Switching modes restarts whichever path takes over from silence
+    const bool linearPhase = linearPhase_.load(std::memory_order_relaxed);
+    if (linearPhase != linearPhaseActive_) {
+        linearPhaseActive_ = linearPhase;
+        convolver_.reset();
+        cascade_.reset();
+        mixer_.setWetLatency(linearPhase ? LinearPhaseConvolver::getLatencySamples() : 0);
+    }
 
-    lowShelf_.process(context);
-    midPeak_.process(context);
-    highPeak_.process(context);
-    airShelf_.process(context);
+    mixer_.pushDrySamples(buffer);
+
+    if (linearPhase) {
+        convolver_.process(buffer);
+        mixer_.mixWetSamples(buffer);
+        return;
+    }
+
+    const juce::uint32 active = activeBands_.load(std::memory_order_relaxed);
+    const juce::uint32 dynamic = dynamicBands_.load(std::memory_order_relaxed) & active;
+
+    if (dynamic == 0) {
+        // Static bands: one pass over the whole block
+        cascade_.process(buffer, active);
+    } else {
+        // Dynamic bands follow their envelopes at control rate; the cascade
+        // ramps to each new response across the control block
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = std::min(buffer.getNumChannels(), 2);
+        for (int start = 0; start < numSamples; start += kControlBlockSize) {
+            const int count = std::min(kControlBlockSize, numSamples - start);
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, start, count);
+            processDynamicBands(block, dynamic);
+            cascade_.process(block, active);
+        }
+    }
 
     // Apply dry/wet mix
-    if (params_.dryWet < 1.0f) {
-        // This is simplified - a proper implementation would keep a dry copy
-        // For now, dryWet just scales the processed signal
-        buffer.applyGain(params_.dryWet);
+    mixer_.mixWetSamples(buffer);
+}
+
+void Equalizer::processDynamicBands(juce::AudioBuffer<float>& buffer, juce::uint32 dynamicBands) {
+    using Coeffs = juce::dsp::IIR::ArrayCoefficients<float>;
+
+    const int numSamples = buffer.getNumSamples();
+    const float* left = buffer.getReadPointer(0);
+    const float* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : left;
+
+    for (int b = 0; b < NUM_BANDS; ++b) {
+        if ((dynamicBands & (1u << b)) == 0) continue;
+
+        const EQBandParams band = params_.bands[static_cast<size_t>(b)];
+        auto& det = detectors_[static_cast<size_t>(b)];
+
+        // Band-pass key around the band, mono sum
+        const float frequency = juce::jlimit(20.0f, static_cast<float>(sampleRate_) * 0.49f,
+                                             frequencyCurve().toPhysical(band.frequency));
+        const auto c = Coeffs::makeBandPass(sampleRate_, frequency, qCurve().toPhysical(band.q));
+        det.b0 = c[0]; det.b1 = c[1]; det.b2 = c[2]; det.a1 = c[4]; det.a2 = c[5];
+
+        for (int i = 0; i < numSamples; ++i) {
+            const float x = 0.5f * (left[i] + right[i]);
+            const float y = det.b0 * x + det.s1;
+            det.s1 = det.b1 * x - det.a1 * y + det.s2;
+            det.s2 = det.b2 * x - det.a2 * y;
+
+            const float level = std::abs(y);
+            const float coeff = level > det.envelope ? detectorAttack_ : detectorRelease_;
+            det.envelope = level + coeff * (det.envelope - level);
+        }
+
+        // Below threshold the band is flat; it reaches its full gain 12dB above.
+        // Dynamic amount blends between that and the static gain.
+        const float levelDb = juce::Decibels::gainToDecibels(det.envelope, -100.0f);
+        const float thresholdDb = thresholdCurve().toPhysical(band.threshold);
+        const float follow = juce::jlimit(0.0f, 1.0f, (levelDb - thresholdDb) / 12.0f);
+        const float gainDb = getBandGainDb(band) * ((1.0f - band.dynamic) + band.dynamic * follow);
+
+        cascade_.rampSection(b, designBand(band, gainDb));
     }
 }
 
 void Equalizer::reset() {
-    lowShelf_.reset();
-    midPeak_.reset();
-    highPeak_.reset();
-    airShelf_.reset();
+    cascade_.reset();
+    detectors_.fill(BandDetector{});
+    convolver_.reset();
+    mixer_.reset();
+}
+
+int Equalizer::getLatencySamples() const {
+    return linearPhase_.load(std::memory_order_relaxed) ? LinearPhaseConvolver::getLatencySamples() : 0;
 }
 
 void Equalizer::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.lowGain = value; break;
-        case 1: params_.midGain = value; break;
-        case 2: params_.highGain = value; break;
-        case 3: params_.airGain = value; break;
-        case 4: params_.dryWet = value; break;
+    if (!setParameterValue(params_, index, value)) return;
+
+    // Only the band that moved needs new coefficients. In a batch each band
+    // is redesigned once, and the FIR once for all of them.
+    const int band = bandForParameter(index);
+    if (band >= 0) {
+        if (isChangingParameters()) {
+            bandsChanged_ |= 1u << band;
+            kernelChanged_ = true;
+            return;
+        }
+        updateBand(band);
+        updateLinearPhase();
+    } else if (index == kLinearPhaseParameter) {
+        if (isChangingParameters()) {
+            kernelChanged_ = true;
+            return;
+        }
+        updateLinearPhase();
+    } else {
+        mixer_.setWetMix(params_.dryWet);
     }
+}
 
-    updateFilters();
+void Equalizer::parameterChangesFinished() {
+    for (int band = 0; band < NUM_BANDS; ++band) {
+        if ((bandsChanged_ & (1u << band)) != 0) {
+            updateBand(band);
+        }
+    }
+    bandsChanged_ = 0;
+
+    if (kernelChanged_) {
+        kernelChanged_ = false;
+        updateLinearPhase();
+    }
 }
 
 float Equalizer::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.lowGain;
-        case 1: return params_.midGain;
-        case 2: return params_.highGain;
-        case 3: return params_.airGain;
-        case 4: return params_.dryWet;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Equalizer::getParameterName(int index) const {
-    static const char* names[] = {"Low", "Mid", "High", "Air", "Dry/Wet"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<EQParams>(index);
 }
 
 void Equalizer::setParams(const EQParams& params) {
@@ -82,27 +205,78 @@ void Equalizer::setParams(const EQParams& params) {
 }
 
 void Equalizer::updateFilters() {
+    mixer_.setWetMix(params_.dryWet);
+
+    for (int band = 0; band < NUM_BANDS; ++band) {
+        updateBand(band);
+    }
+    updateLinearPhase();
+}
+
+Equalizer::BandType Equalizer::getBandType(const EQBandParams& band) {
+    const int type = juce::jlimit(0, 5, static_cast<int>(std::round(band.type * 5.0f)));
+    return static_cast<BandType>(type);
+}
+
+float Equalizer::getBandGainDb(const EQBandParams& band) {
     // Convert 0-1 to dB (-12 to +12)
-    auto gainToDB = [](float normalized) {
-        return (normalized - 0.5f) * 24.0f;  // -12 to +12 dB
-    };
+    return parameterCurve<EQParams>(gainParameterIndex(0)).toPhysical(band.gain);
+}
+
+std::array<double, 6> Equalizer::designBand(const EQBandParams& band, float gainDb) const {
+    using Coeffs = juce::dsp::IIR::ArrayCoefficients<double>;
 
-    float lowDB = gainToDB(params_.lowGain);
-    float midDB = gainToDB(params_.midGain);
-    float highDB = gainToDB(params_.highGain);
-    float airDB = gainToDB(params_.airGain);
+    // Frequency: 20Hz to 20kHz (log), Q: 0.1 to 10 (log)
+    const double frequency = juce::jlimit(20.0, sampleRate_ * 0.49,
+                                          static_cast<double>(frequencyCurve().toPhysical(band.frequency)));
+    const double q = static_cast<double>(qCurve().toPhysical(band.q));
+    const double gain = static_cast<double>(juce::Decibels::decibelsToGain(gainDb));
+
+    switch (getBandType(band)) {
+        case BandType::Peak: return Coeffs::makePeakFilter(sampleRate_, frequency, q, gain);
+        case BandType::LowShelf: return Coeffs::makeLowShelf(sampleRate_, frequency, q, gain);
+        case BandType::HighShelf: return Coeffs::makeHighShelf(sampleRate_, frequency, q, gain);
+        case BandType::LowCut: return Coeffs::makeHighPass(sampleRate_, frequency, q);
+        case BandType::HighCut: return Coeffs::makeLowPass(sampleRate_, frequency, q);
+        case BandType::Notch: return Coeffs::makeNotch(sampleRate_, frequency, q);
+    }
+    return {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+}
 
-    *lowShelf_.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        sampleRate_, LOW_FREQ, Q, juce::Decibels::decibelsToGain(lowDB));
+void Equalizer::updateBand(int band) {
+    if (band < 0 || band >= NUM_BANDS) return;
 
-    *midPeak_.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate_, MID_FREQ, Q, juce::Decibels::decibelsToGain(midDB));
+    const auto& params = params_.bands[static_cast<size_t>(band)];
+    const BandType type = getBandType(params);
+    const float gainDb = getBandGainDb(params);
+    const juce::uint32 bit = 1u << band;
 
-    *highPeak_.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate_, HIGH_FREQ, Q, juce::Decibels::decibelsToGain(highDB));
+    // Flat gain bands are skipped entirely; cuts and notches always filter
+    const bool shapesGain = type == BandType::Peak || type == BandType::LowShelf
+                            || type == BandType::HighShelf;
+    const bool active = params.enabled >= 0.5f && (!shapesGain || std::abs(gainDb) > 0.01f);
+    const bool dynamic = active && shapesGain && params.dynamic > 0.0f;
 
-    *airShelf_.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        sampleRate_, AIR_FREQ, Q, juce::Decibels::decibelsToGain(airDB));
+    // Static response; dynamic bands start here and are then driven by the audio thread
+    const auto coefficients = designBand(params, gainDb);
+    cascade_.setSection(band, coefficients);
+    staticSections_[static_cast<size_t>(band)] = BiquadCascade::Coefficients::fromArray(coefficients);
+
+    if (active) activeBands_.fetch_or(bit, std::memory_order_relaxed);
+    else activeBands_.fetch_and(~bit, std::memory_order_relaxed);
+
+    if (dynamic) dynamicBands_.fetch_or(bit, std::memory_order_relaxed);
+    else dynamicBands_.fetch_and(~bit, std::memory_order_relaxed);
+}
+
+void Equalizer::updateLinearPhase() {
+    const bool linearPhase = params_.linearPhase >= 0.5f;
+    linearPhase_.store(linearPhase, std::memory_order_relaxed);
+
+    // The FIR is redesigned in the background and crossfaded in
+    if (linearPhase) {
+        convolver_.requestKernel(staticSections_, activeBands_.load(std::memory_order_relaxed));
+    }
 }
 
 } // namespace incant
@@ -1,12 +1,41 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "BiquadCascade.h"
+#include "DryWetMixer.h"
+#include "LinearPhaseConvolver.h"
+#include "../ParameterMapping.h"
+#include <atomic>
 
 namespace incant {
 
+// Parametric EQ with up to 16 bands. Each band has its own type, frequency,
+// Q and gain, and can optionally act dynamically: its gain then follows the
+// level of the signal around the band's frequency.
+//
+// In linear-phase mode the same static response runs as an FIR through an
+// FFT convolver instead of the biquad cascade; dynamic bands then stay at
+// their static gain, and the plugin reports the FIR's latency.
+//
+// Parameter layout (keeps the original five-knob layout first):
+//   0-3   gains of bands 1-4, 4 dry/wet, 5-16 gains of bands 5-16,
+//   17+   six per band: enabled, type, frequency, Q, dynamic, threshold,
+//   then the linear-phase switch
 class Equalizer : public EffectBase {
 public:
+    static constexpr int NUM_BANDS = EQParams::kMaxBands;
+
+    enum class BandField { Enabled, Type, Frequency, Q, Dynamic, Threshold };
+    static constexpr int kFieldsPerBand = 6;
+    static constexpr int kFirstBandField = 17;
+    static constexpr int kLinearPhaseParameter = kFirstBandField + NUM_BANDS * kFieldsPerBand;
+    static constexpr int kNumParameters = kLinearPhaseParameter + 1;
+
+    static constexpr int gainParameterIndex(int band) { return band < 4 ? band : band + 1; }
+    static constexpr int bandParameterIndex(int band, BandField field) {
+        return kFirstBandField + band * kFieldsPerBand + static_cast<int>(field);
+    }
+
     Equalizer();
     ~Equalizer() override = default;
 
@@ -16,31 +45,57 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return kNumParameters; }
     const char* getParameterName(int index) const override;
+    int getLatencySamples() const override;
 
     void setParams(const EQParams& params);
 
 private:
+    enum class BandType { Peak, LowShelf, HighShelf, LowCut, HighCut, Notch };
+
+    // Envelope of one dynamic band, fed by a band-pass around its frequency
+    struct BandDetector {
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float s1 = 0.0f, s2 = 0.0f;
+        float envelope = 0.0f;
+    };
+
+    void parameterChangesFinished() override;
+
     void updateFilters();
+    void updateBand(int band);
+    void updateLinearPhase();
+    std::array<double, 6> designBand(const EQBandParams& band, float gainDb) const;
+    void processDynamicBands(juce::AudioBuffer<float>& buffer, juce::uint32 dynamicBands);
+
+    static BandType getBandType(const EQBandParams& band);
+    static float getBandGainDb(const EQBandParams& band);
 
     EQParams params_;
 
-    // Biquad filters for each band (stereo)
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> lowShelf_;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> midPeak_;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> highPeak_;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> airShelf_;
-
-    static constexpr float LOW_FREQ = 100.0f;
-    static constexpr float MID_FREQ = 1000.0f;
-    static constexpr float HIGH_FREQ = 4000.0f;
-    static constexpr float AIR_FREQ = 10000.0f;
-    static constexpr float Q = 0.707f;
+    // All bands as one stereo cascade; only active bands are run
+    BiquadCascade cascade_;
+    std::atomic<juce::uint32> activeBands_{0};
+    std::atomic<juce::uint32> dynamicBands_{0};
+
+    // Linear-phase path, designed from the static response of every band
+    LinearPhaseConvolver convolver_;
+    std::array<BiquadCascade::Coefficients, NUM_BANDS> staticSections_{};
+    std::atomic<bool> linearPhase_{false};
+    bool linearPhaseActive_ = false;  // audio thread's view of linearPhase_
+
+    // Work deferred while a batch of parameter changes is applied
+    juce::uint32 bandsChanged_ = 0;
+    bool kernelChanged_ = false;
+
+    // Dynamic bands are re-designed every control block
+    static constexpr int kControlBlockSize = 32;
+    std::array<BandDetector, NUM_BANDS> detectors_{};
+    float detectorAttack_ = 0.0f;
+    float detectorRelease_ = 0.0f;
+
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
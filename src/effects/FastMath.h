@@ -0,0 +1,39 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <cstring>
+
+namespace incant {
+
+// 20 * log10(2): converts log2 amplitude to dB
+constexpr float kDbPerLog2 = 6.0205999f;
+
+// Polynomial log2/exp2 approximations (well under 0.01 dB of error).
+// Branch-free so per-sample loops using them can be auto-vectorised.
+inline float fastLog2(float x) {
+    std::int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const float exponent = static_cast<float>(((bits >> 23) & 0xff) - 127);
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    // log2(m) = 2/ln2 * atanh(t), t = (m - 1) / (m + 1), series to t^7
+    const float t = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    return exponent + t * (2.8853901f + t2 * (0.96179669f + t2 * (0.57707802f + t2 * 0.41219859f)));
+}
+
+inline float fastExp2(float x) {
+    x = juce::jlimit(-126.0f, 126.0f, x);
+    int xi = static_cast<int>(x);
+    xi -= (x < static_cast<float>(xi)) ? 1 : 0;
+    const float f = x - static_cast<float>(xi);
+    const float p = 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.05550411f + f * (0.00961813f + f * 0.00133336f))));
+    const std::int32_t bits = (xi + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return scale * p;
+}
+
+} // namespace incant
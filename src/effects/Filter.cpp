@@ -1,14 +1,39 @@
 #include "Filter.h"
+#include "FastMath.h"
 #include <cmath>
 
 namespace incant {
 
+namespace {
+
+// The cutoff curve spans 20Hz to 20kHz, log2(1000) octaves
+const float kNormalizedPerOctave = 1.0f / std::log2(1000.0f);
+
+// Bottom of the envelope's -60..0 dBFS range, as a linear level
+constexpr float kEnvelopeFloor = 0.001f;
+
+} // namespace
+
 Filter::Filter() {
+    // Cutoff glides like an analog sweep; the rest ramps linearly
+    setSmoothing(0, Ramp::OnePole, 20.0f, params_.cutoff);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.resonance);
+    setSmoothing(3, Ramp::Linear, 50.0f, params_.lfoDepth);
+    setSmoothing(5, Ramp::Linear, 50.0f, params_.envDepth);
 }
 
 void Filter::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
     blockSize_ = samplesPerBlock;
+    prepareSmoothing(sampleRate);
+
+    const auto& cutoffCurve = parameterCurve<FilterParams>(0);
+    const float maxFreq = std::min(cutoffCurve.getMaximum(), static_cast<float>(sampleRate) * 0.45f);
+    cutoffCoefficients_.build([&](float normalized) {
+        const float cutoff = std::min(cutoffCurve.toPhysical(normalized), maxFreq);
+        return std::tan(juce::MathConstants<float>::pi * cutoff / static_cast<float>(sampleRate));
+    });
+
     reset();
 }
 
@@ -17,81 +42,104 @@ void Filter::process(juce::AudioBuffer<float>& buffer) {
     const int numChannels = std::min(buffer.getNumChannels(), 2);
 
     // LFO rate: 0.1 to 10 Hz
-    float lfoFreq = 0.1f + params_.lfoRate * 9.9f;
+    float lfoFreq = parameterCurve<FilterParams>(2).toPhysical(params_.lfoRate);
     float lfoIncrement = lfoFreq / static_cast<float>(sampleRate_);
 
-    // Base cutoff frequency: 20Hz to 20kHz (exponential)
-    float minFreq = 20.0f;
-    float maxFreq = std::min(20000.0f, static_cast<float>(sampleRate_) * 0.45f);
-
-    float baseCutoff = minFreq * std::pow(maxFreq / minFreq, params_.cutoff);
-
-    // Resonance (Q): 0.5 to 20
-    float resonance = 0.5f + params_.resonance * 19.5f;
-
     FilterType filterType = getFilterType();
 
-    for (int sample = 0; sample < numSamples; ++sample) {
-        // Calculate LFO modulation
-        float lfo = std::sin(lfoPhase_ * 2.0f * juce::MathConstants<float>::pi);
-
-        // Apply LFO depth to cutoff (in octaves, -2 to +2)
-        float lfoOctaves = lfo * params_.lfoDepth * 2.0f;
-        float modulatedCutoff = baseCutoff * std::pow(2.0f, lfoOctaves);
-
-        // Clamp cutoff
-        modulatedCutoff = juce::jlimit(minFreq, maxFreq, modulatedCutoff);
-
-        // Calculate SVF coefficients for this cutoff
-        // Using Andy Simper's SVF implementation
-        float w = std::tan(juce::MathConstants<float>::pi * modulatedCutoff / static_cast<float>(sampleRate_));
-        float g = w;
-        float k = 1.0f / resonance;
-
-        float a1 = 1.0f / (1.0f + g * (g + k));
-        float a2 = g * a1;
-        float a3 = g * a2;
-
-        // Process each channel
-        for (int ch = 0; ch < numChannels; ++ch) {
-            SVFState& state = (ch == 0) ? stateL_ : stateR_;
-
-            float input = buffer.getSample(ch, sample);
-
-            // SVF tick
-            float v3 = input - state.ic2eq;
-            float v1 = a1 * state.ic1eq + a2 * v3;
-            float v2 = state.ic2eq + a2 * state.ic1eq + a3 * v3;
-
-            state.ic1eq = 2.0f * v1 - state.ic1eq;
-            state.ic2eq = 2.0f * v2 - state.ic2eq;
-
-            // Select output based on filter type
-            float output;
-            switch (filterType) {
-                case FilterType::LowPass:
-                    output = v2;
-                    break;
-                case FilterType::HighPass:
-                    output = input - k * v1 - v2;
-                    break;
-                case FilterType::BandPass:
-                    output = v1;
-                    break;
-                case FilterType::Notch:
-                    output = input - k * v1;
-                    break;
-                default:
-                    output = v2;
+    // Envelope follower: attack 0.1 to 100ms, release 10 to 1000ms.
+    // The key is read in the same sample loop, straight from the sidechain bus.
+    const float envAttack = envelopeCoefficient(parameterCurve<FilterParams>(6).toPhysical(params_.envAttack), sampleRate_);
+    const float envRelease = envelopeCoefficient(parameterCurve<FilterParams>(7).toPhysical(params_.envRelease), sampleRate_);
+    const bool keyed = params_.envSource >= 0.5f && sidechain_ != nullptr
+                       && sidechain_->getNumChannels() > 0;
+    const auto& envSource = keyed ? *sidechain_ : buffer;
+    const int envChannels = std::min(envSource.getNumChannels(), 2);
+
+    // Derived values follow the smoothed parameters at control rate
+    processSmoothed(numSamples, [&](int start, int count) {
+        // Cutoff stays normalized; modulation in octaves moves it along the curve
+        const float baseCutoff = smoothedValue(0);
+
+        // Resonance (Q): 0.5 to 20
+        const float resonance = parameterCurve<FilterParams>(1).toPhysical(smoothedValue(1));
+        const float k = 1.0f / resonance;
+
+        // LFO depth up to +-2 octaves, envelope up to +4
+        const float lfoOctaves = parameterCurve<FilterParams>(3).toPhysical(smoothedValue(3));
+        const float envOctaves = parameterCurve<FilterParams>(5).toPhysical(smoothedValue(5));
+        const float envOctavesPerLog2 = envOctaves * kDbPerLog2 / 60.0f;
+
+        for (int sample = start; sample < start + count; ++sample) {
+            // Calculate LFO modulation
+            float lfo = std::sin(lfoPhase_ * 2.0f * juce::MathConstants<float>::pi);
+
+            // Apply LFO depth to cutoff (in octaves, -2 to +2)
+            float lfoOffset = lfo * lfoOctaves;
+
+            // Follow the envelope in the linear domain, mapping -60..0 dBFS
+            // onto 0..envOctaves through the polynomial log2
+            float envOffset = 0.0f;
+            if (envOctaves > 0.0f) {
+                float level = 0.0f;
+                for (int ch = 0; ch < envChannels; ++ch) {
+                    level = std::max(level, std::abs(envSource.getSample(ch, sample)));
+                }
+                const float coeff = level > envelope_ ? envAttack : envRelease;
+                envelope_ = level + coeff * (envelope_ - level);
+
+                envOffset = envOctaves + envOctavesPerLog2 * fastLog2(std::max(envelope_, kEnvelopeFloor));
             }
 
-            buffer.setSample(ch, sample, output);
-        }
+            // Calculate SVF coefficients for this cutoff (the table clamps it)
+            // Using Andy Simper's SVF implementation
+            float g = cutoffCoefficients_(baseCutoff + (lfoOffset + envOffset) * kNormalizedPerOctave);
+
+            float a1 = 1.0f / (1.0f + g * (g + k));
+            float a2 = g * a1;
+            float a3 = g * a2;
+
+            // Process each channel
+            for (int ch = 0; ch < numChannels; ++ch) {
+                SVFState& state = (ch == 0) ? stateL_ : stateR_;
+
+                float input = buffer.getSample(ch, sample);
+
+                // SVF tick
+                float v3 = input - state.ic2eq;
+                float v1 = a1 * state.ic1eq + a2 * v3;
+                float v2 = state.ic2eq + a2 * state.ic1eq + a3 * v3;
+
+                state.ic1eq = 2.0f * v1 - state.ic1eq;
+                state.ic2eq = 2.0f * v2 - state.ic2eq;
+
+                // Select output based on filter type
+                float output;
+                switch (filterType) {
+                    case FilterType::LowPass:
+                        output = v2;
+                        break;
+                    case FilterType::HighPass:
+                        output = input - k * v1 - v2;
+                        break;
+                    case FilterType::BandPass:
+                        output = v1;
+                        break;
+                    case FilterType::Notch:
+                        output = input - k * v1;
+                        break;
+                    default:
+                        output = v2;
+                }
+
+                buffer.setSample(ch, sample, output);
+            }
 
-        // Advance LFO phase
-        lfoPhase_ += lfoIncrement;
-        if (lfoPhase_ >= 1.0f) lfoPhase_ -= 1.0f;
-    }
+            // Advance LFO phase
+            lfoPhase_ += lfoIncrement;
+            if (lfoPhase_ >= 1.0f) lfoPhase_ -= 1.0f;
+        }
+    });
 }
 
 Filter::FilterType Filter::getFilterType() const {
@@ -105,39 +153,31 @@ void Filter::reset() {
     stateL_ = SVFState{};
     stateR_ = SVFState{};
     lfoPhase_ = 0.0f;
+    envelope_ = 0.0f;
+    snapSmoothing();
 }
 
 void Filter::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.cutoff = value; break;
-        case 1: params_.resonance = value; break;
-        case 2: params_.lfoRate = value; break;
-        case 3: params_.lfoDepth = value; break;
-        case 4: params_.filterType = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
+
+    setSmoothingTarget(index, value);
 }
 
 float Filter::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.cutoff;
-        case 1: return params_.resonance;
-        case 2: return params_.lfoRate;
-        case 3: return params_.lfoDepth;
-        case 4: return params_.filterType;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Filter::getParameterName(int index) const {
-    static const char* names[] = {"Cutoff", "Resonance", "LFO Rate", "LFO Depth", "Type"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<FilterParams>(index);
 }
 
 void Filter::setParams(const FilterParams& params) {
     params_ = params;
+    for (int i = 0; i < getNumParameters(); ++i) {
+        setSmoothingTarget(i, getParameter(i));
+    }
 }
 
 } // namespace incant
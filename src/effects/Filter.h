@@ -1,7 +1,7 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "../ParameterMapping.h"
 
 namespace incant {
 
@@ -16,7 +16,7 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<FilterParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const FilterParams& params);
@@ -46,9 +46,12 @@ private:
     // LFO phase
     float lfoPhase_ = 0.0f;
 
-    // Cached filter coefficients
-    float g_ = 0.0f;
-    float k_ = 0.0f;
+    // Envelope follower (peak level of the input or sidechain key)
+    float envelope_ = 0.0f;
+
+    // SVF g = tan(pi * cutoff / fs) across the normalized cutoff range, so
+    // modulated cutoffs are a lookup rather than pow() and tan() per sample
+    MappingTable<1024> cutoffCoefficients_;
 };
 
 } // namespace incant
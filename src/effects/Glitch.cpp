@@ -3,6 +3,9 @@
 namespace incant {
 
 Glitch::Glitch() : rng_(std::random_device{}()) {
+    // Rate, stutter and reverse are only read when a glitch starts, so they
+    // can't step the output; crush is applied to every glitched sample
+    setSmoothing(2, Ramp::Linear, 50.0f, params_.crush);
 }
 
 void Glitch::prepare(double sampleRate, int samplesPerBlock) {
@@ -14,7 +17,9 @@ void Glitch::prepare(double sampleRate, int samplesPerBlock) {
     captureBuffer_.setSize(2, maxCaptureSamples);
     captureBuffer_.clear();
 
-    dryBuffer_.setSize(2, samplesPerBlock);
+    prepareSmoothing(sampleRate);
+    mixer_.prepare(sampleRate, samplesPerBlock);
+    mixer_.setWetMix(params_.dryWet);
 
     reset();
 }
@@ -22,79 +27,76 @@ void Glitch::prepare(double sampleRate, int samplesPerBlock) {
 void Glitch::process(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
     const int numChannels = std::min(buffer.getNumChannels(), 2);
-    const float dryWet = params_.dryWet;
 
     // Store dry signal
-    for (int ch = 0; ch < numChannels; ++ch) {
-        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-    }
+    mixer_.pushDrySamples(buffer);
+
+    processSmoothed(numSamples, [&](int start, int count) {
+        // Crush depth follows its ramp at control rate
+        const float crush = smoothedValue(2);
+        const float levels = crushLevels(crush);
+
+        for (int sample = start; sample < start + count; ++sample) {
+            // Check if we should trigger a new glitch
+            if (!isGlitching_) {
+                samplesUntilNextGlitch_--;
+                if (samplesUntilNextGlitch_ <= 0) {
+                    triggerGlitch();
+                }
 
-    for (int sample = 0; sample < numSamples; ++sample) {
-        // Check if we should trigger a new glitch
-        if (!isGlitching_) {
-            samplesUntilNextGlitch_--;
-            if (samplesUntilNextGlitch_ <= 0) {
-                triggerGlitch();
+                // Continuously capture audio for potential glitch
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    captureBuffer_.setSample(ch, capturePosition_, buffer.getSample(ch, sample));
+                }
+                capturePosition_ = (capturePosition_ + 1) % captureBuffer_.getNumSamples();
             }
 
-            // Continuously capture audio for potential glitch
-            for (int ch = 0; ch < numChannels; ++ch) {
-                captureBuffer_.setSample(ch, capturePosition_, buffer.getSample(ch, sample));
-            }
-            capturePosition_ = (capturePosition_ + 1) % captureBuffer_.getNumSamples();
-        }
+            // Process glitch if active
+            if (isGlitching_) {
+                // Get sample from captured buffer
+                int readPos;
+                if (isReversed_) {
+                    readPos = (capturePosition_ - 1 - glitchPlaybackPos_ + captureBuffer_.getNumSamples())
+                              % captureBuffer_.getNumSamples();
+                } else {
+                    readPos = (capturePosition_ - captureLength_ + glitchPlaybackPos_ + captureBuffer_.getNumSamples())
+                              % captureBuffer_.getNumSamples();
+                }
 
-        // Process glitch if active
-        if (isGlitching_) {
-            // Get sample from captured buffer
-            int readPos;
-            if (isReversed_) {
-                readPos = (capturePosition_ - 1 - glitchPlaybackPos_ + captureBuffer_.getNumSamples())
-                          % captureBuffer_.getNumSamples();
-            } else {
-                readPos = (capturePosition_ - captureLength_ + glitchPlaybackPos_ + captureBuffer_.getNumSamples())
-                          % captureBuffer_.getNumSamples();
-            }
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    float glitchSample = captureBuffer_.getSample(ch, readPos);
 
-            for (int ch = 0; ch < numChannels; ++ch) {
-                float glitchSample = captureBuffer_.getSample(ch, readPos);
+                    // Apply bit crushing
+                    if (crush > 0.01f) {
+                        glitchSample = std::round(glitchSample * levels) / levels;
+                    }
 
-                // Apply bit crushing
-                if (params_.crush > 0.01f) {
-                    glitchSample = bitCrush(glitchSample, params_.crush);
+                    buffer.setSample(ch, sample, glitchSample);
                 }
 
-                buffer.setSample(ch, sample, glitchSample);
-            }
-
-            // Advance playback
-            glitchPlaybackPos_++;
-            if (glitchPlaybackPos_ >= captureLength_) {
-                glitchPlaybackPos_ = 0;
-                currentRepeat_++;
-
-                // Check if we should continue repeating
-                if (currentRepeat_ >= glitchRepeatCount_) {
-                    isGlitching_ = false;
-                    // Schedule next glitch
-                    float rateMs = 50.0f + (1.0f - params_.rate) * 2000.0f;
-                    samplesUntilNextGlitch_ = static_cast<int>(rateMs * sampleRate_ / 1000.0f);
-                    // Add some randomness
-                    samplesUntilNextGlitch_ = static_cast<int>(
-                        samplesUntilNextGlitch_ * (0.5f + dist_(rng_)));
+                // Advance playback
+                glitchPlaybackPos_++;
+                if (glitchPlaybackPos_ >= captureLength_) {
+                    glitchPlaybackPos_ = 0;
+                    currentRepeat_++;
+
+                    // Check if we should continue repeating
+                    if (currentRepeat_ >= glitchRepeatCount_) {
+                        isGlitching_ = false;
+                        // Schedule next glitch
+                        float rateMs = 50.0f + (1.0f - params_.rate) * 2000.0f;
+                        samplesUntilNextGlitch_ = static_cast<int>(rateMs * sampleRate_ / 1000.0f);
+                        // Add some randomness
+                        samplesUntilNextGlitch_ = static_cast<int>(
+                            samplesUntilNextGlitch_ * (0.5f + dist_(rng_)));
+                    }
                 }
             }
         }
-    }
+    });
 
     // Mix dry/wet
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* out = buffer.getWritePointer(ch);
-        const float* dry = dryBuffer_.getReadPointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            out[i] = dry[i] * (1.0f - dryWet) + out[i] * dryWet;
-        }
-    }
+    mixer_.mixWetSamples(buffer);
 }
 
 void Glitch::triggerGlitch() {
@@ -126,20 +128,13 @@ void Glitch::triggerGlitch() {
     isReversed_ = (dist_(rng_) < params_.reverse);
 }
 
-float Glitch::bitCrush(float sample, float amount) {
-    // amount 0-1 maps to 16 bits down to ~3 bits
+float Glitch::crushLevels(float amount) {
+    // amount 0-1 maps to 16 bits down to ~3 bits; samples are quantized to
+    // this many steps per unit
     float bits = 16.0f - amount * 13.0f;
     bits = std::max(bits, 2.0f);
 
-    float levels = std::pow(2.0f, bits);
-
-    // Quantize
-    sample = std::round(sample * levels) / levels;
-
-    // Optional: add sample rate reduction effect at high crush
-    // (already implicit in the quantization noise)
-
-    return sample;
+    return std::pow(2.0f, bits);
 }
 
 void Glitch::reset() {
@@ -150,6 +145,8 @@ void Glitch::reset() {
     glitchPlaybackPos_ = 0;
     glitchRepeatCount_ = 0;
     currentRepeat_ = 0;
+    mixer_.reset();
+    snapSmoothing();
 
     // Initial delay before first glitch
     samplesUntilNextGlitch_ = static_cast<int>(sampleRate_ * 0.1);
@@ -158,34 +155,24 @@ void Glitch::reset() {
 void Glitch::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.rate = value; break;
-        case 1: params_.stutter = value; break;
-        case 2: params_.crush = value; break;
-        case 3: params_.reverse = value; break;
-        case 4: params_.dryWet = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
+
+    setSmoothingTarget(index, value);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 float Glitch::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.rate;
-        case 1: return params_.stutter;
-        case 2: return params_.crush;
-        case 3: return params_.reverse;
-        case 4: return params_.dryWet;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Glitch::getParameterName(int index) const {
-    static const char* names[] = {"Rate", "Stutter", "Crush", "Reverse", "Dry/Wet"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<GlitchParams>(index);
 }
 
 void Glitch::setParams(const GlitchParams& params) {
     params_ = params;
+    setSmoothingTarget(2, params_.crush);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 } // namespace incant
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterDescriptors.h"
 #include <random>
 
 namespace incant {
@@ -17,14 +18,14 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<GlitchParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const GlitchParams& params);
 
 private:
     void triggerGlitch();
-    float bitCrush(float sample, float amount);
+    static float crushLevels(float amount);
 
     GlitchParams params_;
 
@@ -48,8 +49,8 @@ private:
     std::mt19937 rng_;
     std::uniform_real_distribution<float> dist_{0.0f, 1.0f};
 
-    // Dry buffer for mixing
-    juce::AudioBuffer<float> dryBuffer_;
+    // Dry/wet mixing
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
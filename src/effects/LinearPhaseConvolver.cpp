@@ -0,0 +1,288 @@
+#include "LinearPhaseConvolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace incant {
+
+namespace {
+
+constexpr int ceilLog2(int n) {
+    int order = 0;
+    while ((1 << order) < n) ++order;
+    return order;
+}
+
+// Packs complex bins into / out of JUCE's interleaved real-FFT layout
+void unpackBins(const float* interleaved, std::complex<float>* bins, int numBins) {
+    for (int k = 0; k < numBins; ++k) {
+        bins[k] = {interleaved[2 * k], interleaved[2 * k + 1]};
+    }
+}
+
+void packBins(const std::complex<float>* bins, float* interleaved, int numBins) {
+    for (int k = 0; k < numBins; ++k) {
+        interleaved[2 * k] = bins[k].real();
+        interleaved[2 * k + 1] = bins[k].imag();
+    }
+}
+
+} // namespace
+
+LinearPhaseConvolver::LinearPhaseConvolver() = default;
+
+LinearPhaseConvolver::~LinearPhaseConvolver() {
+    stopWorker();
+}
+
+void LinearPhaseConvolver::prepare() {
+    // The worker may be writing a kernel slot; stop it before reallocating
+    stopWorker();
+
+    fft_ = std::make_unique<juce::dsp::FFT>(ceilLog2(2 * kPartitionSize));
+
+    for (auto& kernel : kernels_) {
+        kernel.assign(static_cast<size_t>(kNumPartitions * kNumBins), {0.0f, 0.0f});
+    }
+
+    // Flat response: a unit impulse at the centre tap, which lands at the start
+    // of one partition and so has an all-ones spectrum there
+    const int centrePartition = (kFirLength / 2) / kPartitionSize;
+    std::fill_n(kernels_[0].begin() + centrePartition * kNumBins, kNumBins, std::complex<float>(1.0f, 0.0f));
+    activeKernel_.store(0);
+    kernelState_.store(Idle);
+
+    for (int ch = 0; ch < kMaxChannels; ++ch) {
+        history_[static_cast<size_t>(ch)].assign(static_cast<size_t>(kNumPartitions * kNumBins), {0.0f, 0.0f});
+        inputFrame_[static_cast<size_t>(ch)].assign(static_cast<size_t>(2 * kPartitionSize), 0.0f);
+        output_[static_cast<size_t>(ch)].assign(static_cast<size_t>(kPartitionSize), 0.0f);
+    }
+    for (auto& acc : accumulators_) {
+        acc.assign(static_cast<size_t>(kNumBins), {0.0f, 0.0f});
+    }
+
+    // Real-only transforms work in place on twice the FFT size
+    fftBuffer_.assign(static_cast<size_t>(4 * kPartitionSize), 0.0f);
+    fadeBuffer_.assign(static_cast<size_t>(kPartitionSize), 0.0f);
+
+    historyPos_ = 0;
+    inputFill_ = 0;
+}
+
+void LinearPhaseConvolver::reset() {
+    for (int ch = 0; ch < kMaxChannels; ++ch) {
+        std::fill(history_[static_cast<size_t>(ch)].begin(), history_[static_cast<size_t>(ch)].end(),
+                  std::complex<float>(0.0f, 0.0f));
+        std::fill(inputFrame_[static_cast<size_t>(ch)].begin(), inputFrame_[static_cast<size_t>(ch)].end(), 0.0f);
+        std::fill(output_[static_cast<size_t>(ch)].begin(), output_[static_cast<size_t>(ch)].end(), 0.0f);
+    }
+    historyPos_ = 0;
+    inputFill_ = 0;
+}
+
+void LinearPhaseConvolver::process(juce::AudioBuffer<float>& buffer) {
+    if (fft_ == nullptr) return;
+
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = std::min(buffer.getNumChannels(), kMaxChannels);
+
+    // Input goes into the current partition while the previous partition's
+    // result is played out, one partition behind
+    for (int pos = 0; pos < numSamples;) {
+        const int count = std::min(numSamples - pos, kPartitionSize - inputFill_);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* data = buffer.getWritePointer(ch, pos);
+            float* frame = inputFrame_[static_cast<size_t>(ch)].data() + kPartitionSize + inputFill_;
+            std::memcpy(frame, data, sizeof(float) * static_cast<size_t>(count));
+            std::memcpy(data, output_[static_cast<size_t>(ch)].data() + inputFill_,
+                        sizeof(float) * static_cast<size_t>(count));
+        }
+
+        pos += count;
+        inputFill_ += count;
+        if (inputFill_ == kPartitionSize) {
+            processPartition();
+            inputFill_ = 0;
+        }
+    }
+}
+
+void LinearPhaseConvolver::processPartition() {
+    // A finished kernel waits in the spare slot; switch to it and fade across
+    const bool fading = kernelState_.load(std::memory_order_acquire) == Pending;
+    const int oldKernel = activeKernel_.load(std::memory_order_relaxed);
+    const int newKernel = fading ? 1 - oldKernel : oldKernel;
+    if (fading) activeKernel_.store(newKernel, std::memory_order_relaxed);
+
+    for (int ch = 0; ch < kMaxChannels; ++ch) {
+        auto& frame = inputFrame_[static_cast<size_t>(ch)];
+
+        // Spectrum of the last two partitions of input into the delay line
+        std::copy(frame.begin(), frame.end(), fftBuffer_.begin());
+        std::fill(fftBuffer_.begin() + 2 * kPartitionSize, fftBuffer_.end(), 0.0f);
+        fft_->performRealOnlyForwardTransform(fftBuffer_.data(), true);
+        unpackBins(fftBuffer_.data(), history_[static_cast<size_t>(ch)].data() + historyPos_ * kNumBins, kNumBins);
+
+        float* out = output_[static_cast<size_t>(ch)].data();
+        accumulate(ch, kernels_[static_cast<size_t>(newKernel)], accumulators_[0].data());
+        inverseToOutput(accumulators_[0].data(), out);
+
+        if (fading) {
+            accumulate(ch, kernels_[static_cast<size_t>(oldKernel)], accumulators_[1].data());
+            inverseToOutput(accumulators_[1].data(), fadeBuffer_.data());
+
+            const float step = 1.0f / static_cast<float>(kPartitionSize);
+            for (int i = 0; i < kPartitionSize; ++i) {
+                const float t = (static_cast<float>(i) + 0.5f) * step;
+                out[i] = fadeBuffer_[static_cast<size_t>(i)] + t * (out[i] - fadeBuffer_[static_cast<size_t>(i)]);
+            }
+        }
+
+        // Current partition becomes the previous one
+        std::copy(frame.begin() + kPartitionSize, frame.end(), frame.begin());
+    }
+
+    historyPos_ = (historyPos_ + 1) % kNumPartitions;
+
+    // Old slot is free again for the worker
+    if (fading) kernelState_.store(Idle, std::memory_order_release);
+}
+
+void LinearPhaseConvolver::accumulate(int channel, const Spectrum& kernel, std::complex<float>* out) const {
+    std::fill_n(out, kNumBins, std::complex<float>(0.0f, 0.0f));
+
+    // Y = sum_j X[n - j] * H[j], written out to keep the complex multiply inline
+    const auto& history = history_[static_cast<size_t>(channel)];
+    for (int j = 0; j < kNumPartitions; ++j) {
+        const int slot = (historyPos_ - j + kNumPartitions) % kNumPartitions;
+        const std::complex<float>* x = history.data() + slot * kNumBins;
+        const std::complex<float>* h = kernel.data() + j * kNumBins;
+
+        for (int k = 0; k < kNumBins; ++k) {
+            const float xr = x[k].real(), xi = x[k].imag();
+            const float hr = h[k].real(), hi = h[k].imag();
+            out[k] = {out[k].real() + xr * hr - xi * hi, out[k].imag() + xr * hi + xi * hr};
+        }
+    }
+}
+
+void LinearPhaseConvolver::inverseToOutput(const std::complex<float>* spectrum, float* out) {
+    packBins(spectrum, fftBuffer_.data(), kNumBins);
+    std::fill(fftBuffer_.begin() + 2 * kNumBins, fftBuffer_.end(), 0.0f);
+    fft_->performRealOnlyInverseTransform(fftBuffer_.data());
+
+    // Overlap-save: the first half is circular wrap-around, the second half is valid
+    std::copy_n(fftBuffer_.begin() + kPartitionSize, kPartitionSize, out);
+}
+
+void LinearPhaseConvolver::requestKernel(
+        const std::array<BiquadCascade::Coefficients, BiquadCascade::kMaxSections>& sections,
+        juce::uint32 activeSections) {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        requestedSections_ = sections;
+        requestedActive_ = activeSections;
+        requestPending_ = true;
+
+        if (!worker_.joinable()) {
+            worker_ = std::thread([this] { workerLoop(); });
+        }
+    }
+    requestCondition_.notify_one();
+}
+
+void LinearPhaseConvolver::stopWorker() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        stopRequested_ = true;
+    }
+    requestCondition_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(requestMutex_);
+    stopRequested_ = false;
+    requestPending_ = false;
+}
+
+void LinearPhaseConvolver::workerLoop() {
+    std::array<BiquadCascade::Coefficients, BiquadCascade::kMaxSections> sections;
+    juce::uint32 active = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(requestMutex_);
+            requestCondition_.wait(lock, [this] { return requestPending_ || stopRequested_; });
+            if (stopRequested_) return;
+
+            // Wait for the audio thread to finish with the spare slot. It may
+            // not be running at all, so keep checking for a stop meanwhile.
+            while (kernelState_.load(std::memory_order_acquire) != Idle) {
+                if (requestCondition_.wait_for(lock, std::chrono::milliseconds(5),
+                                               [this] { return stopRequested_; })) {
+                    return;
+                }
+            }
+
+            // Take the latest request; anything arriving during the design queues behind it
+            sections = requestedSections_;
+            active = requestedActive_;
+            requestPending_ = false;
+        }
+
+        const int spare = 1 - activeKernel_.load(std::memory_order_relaxed);
+        designKernel(sections, active, kernels_[static_cast<size_t>(spare)]);
+        kernelState_.store(Pending, std::memory_order_release);
+    }
+}
+
+void LinearPhaseConvolver::designKernel(
+        const std::array<BiquadCascade::Coefficients, BiquadCascade::kMaxSections>& sections,
+        juce::uint32 activeSections, Spectrum& kernel) {
+    // Worker thread only, so allocating here is fine
+    juce::dsp::FFT designFft(ceilLog2(kFirLength));
+    juce::dsp::FFT partitionFft(ceilLog2(2 * kPartitionSize));
+    std::vector<float> response(static_cast<size_t>(2 * kFirLength), 0.0f);
+
+    // Magnitude of the whole cascade on the FIR's frequency grid, zero phase
+    const double twoPi = juce::MathConstants<double>::twoPi;
+    for (int k = 0; k <= kFirLength / 2; ++k) {
+        const double w = twoPi * static_cast<double>(k) / static_cast<double>(kFirLength);
+        const std::complex<double> z1 = std::polar(1.0, -w);
+        const std::complex<double> z2 = z1 * z1;
+
+        double magnitude = 1.0;
+        for (int s = 0; s < BiquadCascade::kMaxSections; ++s) {
+            if ((activeSections & (1u << s)) == 0) continue;
+            const auto& c = sections[static_cast<size_t>(s)];
+            magnitude *= std::abs(c.b0 + c.b1 * z1 + c.b2 * z2) / std::abs(1.0 + c.a1 * z1 + c.a2 * z2);
+        }
+        response[static_cast<size_t>(2 * k)] = static_cast<float>(magnitude);
+    }
+    designFft.performRealOnlyInverseTransform(response.data());
+
+    // Centre the symmetric impulse at kFirLength / 2 and taper it with a
+    // periodic Blackman window, which is symmetric about that same tap
+    std::vector<float> fir(static_cast<size_t>(kFirLength));
+    for (int n = 0; n < kFirLength; ++n) {
+        const double phase = twoPi * static_cast<double>(n) / static_cast<double>(kFirLength);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        const float tap = response[static_cast<size_t>((n + kFirLength / 2) % kFirLength)];
+        fir[static_cast<size_t>(n)] = tap * static_cast<float>(window);
+    }
+
+    // Split into partitions and take each one's spectrum
+    std::vector<float> partition(static_cast<size_t>(4 * kPartitionSize));
+    for (int j = 0; j < kNumPartitions; ++j) {
+        std::fill(partition.begin(), partition.end(), 0.0f);
+        std::copy_n(fir.begin() + j * kPartitionSize, kPartitionSize, partition.begin());
+        partitionFft.performRealOnlyForwardTransform(partition.data(), true);
+        unpackBins(partition.data(), kernel.data() + j * kNumBins, kNumBins);
+    }
+}
+
+} // namespace incant
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace incant {
+
+// Stereo linear-phase FIR built from the magnitude response of a biquad
+// cascade, run through a uniformly partitioned FFT overlap-save convolver.
+//
+// Kernel design (sampling the response, inverse FFT, windowing and
+// partitioning) happens on a worker thread started on first use. Finished
+// kernels go into the free one of two preallocated slots and are handed to
+// the audio thread through an atomic state, which then crossfades from the
+// old kernel to the new one over one partition. The audio thread never
+// allocates, locks or waits.
+class LinearPhaseConvolver {
+public:
+    static constexpr int kFirLength = 8192;
+    static constexpr int kPartitionSize = 256;
+
+    LinearPhaseConvolver();
+    ~LinearPhaseConvolver();
+
+    // Not concurrent with process(); starts from a flat (pure delay) kernel
+    void prepare();
+    void reset();
+
+    // FIR group delay plus one partition of input buffering
+    static constexpr int getLatencySamples() { return kFirLength / 2 + kPartitionSize; }
+
+    // Message thread: design a kernel matching the sections in the mask.
+    // Requests made while a design is running coalesce into the latest one.
+    void requestKernel(const std::array<BiquadCascade::Coefficients, BiquadCascade::kMaxSections>& sections,
+                       juce::uint32 activeSections);
+
+    // Audio thread: convolves the first two channels in place
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    static constexpr int kNumPartitions = kFirLength / kPartitionSize;
+    static constexpr int kNumBins = kPartitionSize + 1;
+    static constexpr int kMaxChannels = 2;
+
+    // Kernel hand-off between the worker and the audio thread
+    enum KernelState { Idle, Pending };
+
+    using Spectrum = std::vector<std::complex<float>>;
+
+    void processPartition();
+    void accumulate(int channel, const Spectrum& kernel, std::complex<float>* out) const;
+    void inverseToOutput(const std::complex<float>* spectrum, float* out);
+
+    void stopWorker();
+    void workerLoop();
+    void designKernel(const std::array<BiquadCascade::Coefficients, BiquadCascade::kMaxSections>& sections,
+                      juce::uint32 activeSections, Spectrum& kernel);
+
+    // Audio thread
+    std::unique_ptr<juce::dsp::FFT> fft_;
+    std::array<Spectrum, 2> kernels_;
+    std::atomic<int> activeKernel_{0};
+    std::atomic<int> kernelState_{Idle};
+
+    std::array<Spectrum, kMaxChannels> history_;    // frequency-domain delay line
+    std::array<std::vector<float>, kMaxChannels> inputFrame_;   // previous + current partition
+    std::array<std::vector<float>, kMaxChannels> output_;       // last finished partition
+    std::vector<float> fftBuffer_;
+    std::vector<float> fadeBuffer_;
+    std::array<Spectrum, 2> accumulators_;
+    int historyPos_ = 0;
+    int inputFill_ = 0;
+
+    // Worker thread
+    std::thread worker_;
+    std::mutex requestMutex_;
+    std::condition_variable requestCondition_;
+    std::array<BiquadCascade::Coefficients, BiquadCascade::kMaxSections> requestedSections_{};
+    juce::uint32 requestedActive_ = 0;
+    bool requestPending_ = false;
+    bool stopRequested_ = false;
+};
+
+} // namespace incant
@@ -4,6 +4,11 @@
 namespace incant {
 
 Overdrive::Overdrive() {
+    setSmoothing(0, Ramp::Multiplicative, 50.0f, params_.drive);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.tone);
+    setSmoothing(2, Ramp::Linear, 50.0f, params_.level);
+    setSmoothing(3, Ramp::Linear, 50.0f, params_.midBoost);
+    setSmoothing(4, Ramp::Linear, 50.0f, params_.tightness);
 }
 
 void Overdrive::prepare(double sampleRate, int samplesPerBlock) {
@@ -19,51 +24,53 @@ void Overdrive::prepare(double sampleRate, int samplesPerBlock) {
     midBoost_.prepare(spec);
     toneFilter_.prepare(spec);
 
+    prepareSmoothing(sampleRate);
     updateFilters();
 }
 
 void Overdrive::process(juce::AudioBuffer<float>& buffer) {
-    const int numSamples = buffer.getNumSamples();
     const int numChannels = std::min(buffer.getNumChannels(), 2);
+    juce::dsp::AudioBlock<float> block(buffer);
 
-    // Calculate drive gain (1x to 100x)
-    float driveGain = 1.0f + params_.drive * 99.0f;
-
-    // Output level (0.1 to 2.0)
-    float outputLevel = 0.1f + params_.level * 1.9f;
+    processSmoothed(buffer.getNumSamples(), [&](int start, int count) {
+        auto chunk = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(count));
+        juce::dsp::ProcessContextReplacing<float> context(chunk);
 
-    // Apply input high-pass (tightness)
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    inputHighPass_.process(context);
+        // Apply input high-pass (tightness)
+        inputHighPass_.process(context);
 
-    // Apply drive and soft clipping
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* data = buffer.getWritePointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            // Apply gain
-            float sample = data[i] * driveGain;
+        // Apply drive and soft clipping
+        const float* drive = smoothedRamp(0);
+        const float driveGain = driveToGain(smoothedValue(0));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* data = buffer.getWritePointer(ch, start);
+            for (int i = 0; i < count; ++i) {
+                // Apply gain
+                float sample = data[i] * (drive != nullptr ? driveToGain(drive[i]) : driveGain);
 
-            // Soft clip (asymmetric TS-style)
-            sample = softClip(sample);
+                // Soft clip (asymmetric TS-style)
+                sample = softClip(sample);
 
-            data[i] = sample;
+                data[i] = sample;
+            }
         }
-    }
 
-    // Apply mid-boost EQ
-    midBoost_.process(context);
+        // Apply mid-boost EQ
+        midBoost_.process(context);
 
-    // Apply tone filter
-    toneFilter_.process(context);
+        // Apply tone filter
+        toneFilter_.process(context);
 
-    // Apply output level
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* data = buffer.getWritePointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            data[i] *= outputLevel;
+        // Apply output level
+        const float* level = smoothedRamp(2);
+        const float outputLevel = levelToGain(smoothedValue(2));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* data = buffer.getWritePointer(ch, start);
+            for (int i = 0; i < count; ++i) {
+                data[i] *= level != nullptr ? levelToGain(level[i]) : outputLevel;
+            }
         }
-    }
+    });
 }
 
 float Overdrive::softClip(float sample) {
@@ -82,67 +89,58 @@ void Overdrive::reset() {
     inputHighPass_.reset();
     midBoost_.reset();
     toneFilter_.reset();
+    snapSmoothing();
+    updateFilters();
 }
 
 void Overdrive::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.drive = value; break;
-        case 1: params_.tone = value; break;
-        case 2: params_.level = value; break;
-        case 3: params_.midBoost = value; break;
-        case 4: params_.tightness = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
 
-    updateFilters();
+    // Everything ramps; the filters follow in process()
+    setSmoothingTarget(index, value);
 }
 
 float Overdrive::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.drive;
-        case 1: return params_.tone;
-        case 2: return params_.level;
-        case 3: return params_.midBoost;
-        case 4: return params_.tightness;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Overdrive::getParameterName(int index) const {
-    static const char* names[] = {"Drive", "Tone", "Level", "MidBoost", "Tightness"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<OverdriveParams>(index);
 }
 
 void Overdrive::setParams(const OverdriveParams& params) {
     params_ = params;
-    updateFilters();
+    for (int i = 0; i < getNumParameters(); ++i) {
+        setSmoothingTarget(i, getParameter(i));
+    }
 }
 
 void Overdrive::updateFilters() {
     // Input high-pass: 60Hz (loose) to 720Hz (tight)
     // This is the "tightness" control - classic TS cuts bass
-    float hpFreq = 60.0f + params_.tightness * 660.0f;
+    float hpFreq = 60.0f + smoothedValue(4) * 660.0f;
     hpFreq = std::min(hpFreq, static_cast<float>(sampleRate_ * 0.45));
 
-    *inputHighPass_.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(
+    *inputHighPass_.state = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(
         sampleRate_, hpFreq);
 
     // Mid-boost: Peak EQ around 720Hz (the TS "hump")
     // Q varies with boost amount
     float midFreq = 720.0f;
-    float midGainDb = params_.midBoost * 12.0f;  // 0 to 12dB boost
-    float midQ = 0.7f + params_.midBoost * 0.8f;  // Q increases with boost
+    const float midBoost = smoothedValue(3);
+    float midGainDb = midBoost * 12.0f;  // 0 to 12dB boost
+    float midQ = 0.7f + midBoost * 0.8f;  // Q increases with boost
 
-    *midBoost_.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
+    *midBoost_.state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(
         sampleRate_, midFreq, midQ, juce::Decibels::decibelsToGain(midGainDb));
 
     // Tone control: Lowpass from 1kHz (dark) to 8kHz (bright)
-    float toneFreq = 1000.0f + params_.tone * 7000.0f;
+    float toneFreq = 1000.0f + smoothedValue(1) * 7000.0f;
     toneFreq = std::min(toneFreq, static_cast<float>(sampleRate_ * 0.45));
 
-    *toneFilter_.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(
+    *toneFilter_.state = juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(
         sampleRate_, toneFreq, 0.707f);
 }
 
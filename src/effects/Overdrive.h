@@ -1,7 +1,7 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "../ParameterDescriptors.h"
 
 namespace incant {
 
@@ -16,12 +16,18 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<OverdriveParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const OverdriveParams& params);
 
 private:
+    void smoothedParametersChanged() override { updateFilters(); }
+
+    // Drive gain (1x to 100x) and output level (0.1 to 2.0)
+    static float driveToGain(float drive) { return 1.0f + drive * 99.0f; }
+    static float levelToGain(float level) { return 0.1f + level * 1.9f; }
+
     void updateFilters();
     float softClip(float sample);
 
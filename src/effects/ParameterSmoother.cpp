@@ -0,0 +1,101 @@
+#include "ParameterSmoother.h"
+#include <algorithm>
+#include <cmath>
+
+namespace incant {
+
+namespace {
+
+// One-pole ramps snap to the target once they are this close
+constexpr float kSettledDistance = 1.0e-5f;
+
+} // namespace
+
+void ParameterSmoother::configure(Ramp ramp, float timeMs, float initialValue) {
+    ramp_ = ramp;
+    timeMs_ = std::max(0.0f, timeMs);
+    target_.store(initialValue);
+    rampTarget_ = initialValue;
+    current_ = initialValue;
+    ramping_ = false;
+    rampValid_ = false;
+    updateRampLength();
+}
+
+void ParameterSmoother::prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    updateRampLength();
+    snapToTarget();
+}
+
+void ParameterSmoother::updateRampLength() {
+    const double samples = sampleRate_ * static_cast<double>(timeMs_) * 0.001;
+    rampLength_ = static_cast<int>(std::round(samples));
+    onePoleCoefficient_ = samples > 0.0 ? static_cast<float>(std::exp(-1.0 / samples)) : 0.0f;
+}
+
+bool ParameterSmoother::beginRamp() {
+    const float target = getTarget();
+    if (target == rampTarget_) return ramping_;
+
+    rampTarget_ = target;
+    if (rampLength_ <= 1 || (ramp_ == Ramp::OnePole && onePoleCoefficient_ <= 0.0f)) {
+        // Too short to ramp: the next block starts at the target
+        current_ = target;
+        ramping_ = false;
+        return false;
+    }
+
+    remaining_ = rampLength_;
+    multiplicative_ = ramp_ == Ramp::Multiplicative && current_ > 0.0f && target > 0.0f;
+    if (multiplicative_) {
+        step_ = std::exp((std::log(target) - std::log(current_)) / static_cast<float>(rampLength_));
+    } else {
+        step_ = (target - current_) / static_cast<float>(rampLength_);
+    }
+    ramping_ = true;
+    return true;
+}
+
+void ParameterSmoother::snapToTarget() {
+    rampTarget_ = getTarget();
+    current_ = rampTarget_;
+    ramping_ = false;
+    rampValid_ = false;
+}
+
+void ParameterSmoother::advance(int numSamples) {
+    rampValid_ = ramping_;
+    if (!ramping_) return;
+
+    numSamples = std::min(numSamples, kMaxBlockSize);
+
+    if (ramp_ == Ramp::OnePole) {
+        for (int i = 0; i < numSamples; ++i) {
+            current_ = rampTarget_ + onePoleCoefficient_ * (current_ - rampTarget_);
+            values_[static_cast<size_t>(i)] = current_;
+        }
+        if (std::abs(rampTarget_ - current_) < kSettledDistance) {
+            current_ = rampTarget_;
+            values_[static_cast<size_t>(numSamples - 1)] = current_;
+            ramping_ = false;
+        }
+        return;
+    }
+
+    const int steps = std::min(numSamples, remaining_);
+    for (int i = 0; i < steps; ++i) {
+        current_ = multiplicative_ ? current_ * step_ : current_ + step_;
+        values_[static_cast<size_t>(i)] = current_;
+    }
+    remaining_ -= steps;
+
+    if (remaining_ == 0) {
+        // Land exactly on the target and hold it for the rest of the block
+        current_ = rampTarget_;
+        std::fill(values_.begin() + std::max(steps - 1, 0), values_.begin() + numSamples, current_);
+        ramping_ = false;
+    }
+}
+
+} // namespace incant
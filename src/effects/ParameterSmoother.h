@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace incant {
+
+// Ramps one parameter towards its latest target.
+//
+// The target may be set from any thread; the audio thread picks it up with
+// beginRamp() and then evaluates the ramp a control block at a time into a
+// small buffer, so per-sample consumers read values instead of stepping the
+// smoother inside their inner loops. Once the target is reached the smoother
+// is idle and costs nothing.
+class ParameterSmoother {
+public:
+    enum class Ramp {
+        Linear,         // constant step, reaches the target after the ramp time
+        Multiplicative, // constant ratio (gains, frequencies); linear through zero
+        OnePole         // exponential approach, ramp time is the time constant
+    };
+
+    static constexpr int kMaxBlockSize = 32;
+
+    void configure(Ramp ramp, float timeMs, float initialValue);
+    void prepare(double sampleRate);
+
+    // Any thread
+    void setTarget(float value) { target_.store(value, std::memory_order_relaxed); }
+    float getTarget() const { return target_.load(std::memory_order_relaxed); }
+
+    // Audio thread: starts ramping to the latest target if it moved.
+    // Returns true while a ramp is running.
+    bool beginRamp();
+
+    // Audio thread: jumps to the target, dropping any ramp in progress
+    void snapToTarget();
+
+    // Audio thread: fills the next numSamples (at most kMaxBlockSize) ramp
+    // values; getRamp() returns them until the next call. Idle smoothers only
+    // clear the buffer's validity.
+    void advance(int numSamples);
+
+    bool isRamping() const { return ramping_; }
+    float getCurrentValue() const { return current_; }
+
+    // Values for the block last advanced, or nullptr when it was steady
+    const float* getRamp() const { return rampValid_ ? values_.data() : nullptr; }
+
+private:
+    void updateRampLength();
+
+    Ramp ramp_ = Ramp::Linear;
+    float timeMs_ = 50.0f;
+    double sampleRate_ = 44100.0;
+    int rampLength_ = 0;            // Linear / Multiplicative, in samples
+    float onePoleCoefficient_ = 0.0f;
+
+    std::atomic<float> target_{0.0f};
+
+    // Audio thread
+    float rampTarget_ = 0.0f;
+    float current_ = 0.0f;
+    float step_ = 0.0f;             // increment, or ratio for multiplicative ramps
+    bool multiplicative_ = false;
+    int remaining_ = 0;
+    bool ramping_ = false;
+    bool rampValid_ = false;
+    std::array<float, kMaxBlockSize> values_{};
+};
+
+} // namespace incant
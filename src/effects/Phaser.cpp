@@ -4,11 +4,28 @@
 namespace incant {
 
 Phaser::Phaser() {
+    // Stages is a stage count, not a level, and switches at once
+    setSmoothing(0, Ramp::Linear, 50.0f, params_.rate);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.depth);
+    setSmoothing(2, Ramp::Linear, 50.0f, params_.feedback);
 }
 
 void Phaser::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
     blockSize_ = samplesPerBlock;
+
+    prepareSmoothing(sampleRate);
+    mixer_.prepare(sampleRate, samplesPerBlock);
+    mixer_.setWetMix(params_.dryWet);
+
+    // Frequency range for phaser sweep
+    const auto sweepCurve = MappingCurve::exponential(100.0f, 4000.0f);
+    sweepCoefficients_.build([&](float sweepNorm) {
+        const float w0 = 2.0f * juce::MathConstants<float>::pi * sweepCurve.toPhysical(sweepNorm)
+                         / static_cast<float>(sampleRate);
+        return (1.0f - std::tan(w0 * 0.5f)) / (1.0f + std::tan(w0 * 0.5f));
+    });
+
     reset();
 }
 
@@ -16,10 +33,6 @@ void Phaser::process(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
     const int numChannels = std::min(buffer.getNumChannels(), 2);
 
-    // LFO rate: 0.05 to 5 Hz
-    float lfoFreq = 0.05f + params_.rate * 4.95f;
-    float lfoIncrement = lfoFreq / static_cast<float>(sampleRate_);
-
     // Determine number of stages: 4, 6, 8, or 12
     int numStages;
     if (params_.stages < 0.25f) numStages = 4;
@@ -27,60 +40,65 @@ void Phaser::process(juce::AudioBuffer<float>& buffer) {
     else if (params_.stages < 0.75f) numStages = 8;
     else numStages = 12;
 
-    // Feedback amount (limit to prevent instability)
-    float feedback = params_.feedback * 0.85f;
+    mixer_.pushDrySamples(buffer);
 
-    float dryWet = params_.dryWet;
+    processSmoothed(numSamples, [&](int start, int count) {
+        // LFO rate: 0.05 to 5 Hz, at control rate; depth and feedback ramp per sample
+        const float lfoFreq = parameterCurve<PhaserParams>(0).toPhysical(smoothedValue(0));
+        const float lfoIncrement = lfoFreq / static_cast<float>(sampleRate_);
+        const float* depthRamp = smoothedRamp(1);
+        const float* feedbackRamp = smoothedRamp(2);
+        const float steadyDepth = smoothedValue(1);
+        const float steadyFeedback = smoothedValue(2);
 
-    // Frequency range for phaser sweep
-    float minFreq = 100.0f;
-    float maxFreq = 4000.0f;
+        for (int sample = start; sample < start + count; ++sample) {
+            const int i = sample - start;
 
-    for (int sample = 0; sample < numSamples; ++sample) {
-        // Calculate LFO (sine wave)
-        float lfo = std::sin(lfoPhase_ * 2.0f * juce::MathConstants<float>::pi);
+            // Feedback amount (limit to prevent instability)
+            const float feedback = (feedbackRamp != nullptr ? feedbackRamp[i] : steadyFeedback) * 0.85f;
 
-        // Apply depth to LFO
-        lfo *= params_.depth;
+            // Calculate LFO (sine wave)
+            float lfo = std::sin(lfoPhase_ * 2.0f * juce::MathConstants<float>::pi);
 
-        // Calculate sweep frequency
-        float sweepNorm = 0.5f + 0.5f * lfo;  // 0 to 1
-        float sweepFreq = minFreq * std::pow(maxFreq / minFreq, sweepNorm);
+            // Apply depth to LFO
+            lfo *= depthRamp != nullptr ? depthRamp[i] : steadyDepth;
 
-        // Calculate all-pass coefficient from frequency
-        float w0 = 2.0f * juce::MathConstants<float>::pi * sweepFreq / static_cast<float>(sampleRate_);
-        float coefficient = (1.0f - std::tan(w0 * 0.5f)) / (1.0f + std::tan(w0 * 0.5f));
+            // Calculate sweep frequency
+            float sweepNorm = 0.5f + 0.5f * lfo;  // 0 to 1
 
-        // Get input samples
-        float inputL = buffer.getSample(0, sample);
-        float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
+            // All-pass coefficient for that point of the sweep
+            float coefficient = sweepCoefficients_(sweepNorm);
 
-        // Add feedback
-        float wetL = inputL + feedbackL_ * feedback;
-        float wetR = inputR + feedbackR_ * feedback;
+            // Get input samples
+            float inputL = buffer.getSample(0, sample);
+            float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
 
-        // Process through all-pass stages
-        for (int stage = 0; stage < numStages; ++stage) {
-            wetL = stages_[stage].process(wetL, 0, coefficient);
-            wetR = stages_[stage].process(wetR, 1, coefficient);
-        }
+            // Add feedback
+            float wetL = inputL + feedbackL_ * feedback;
+            float wetR = inputR + feedbackR_ * feedback;
 
-        // Store feedback (from output of all-pass chain)
-        feedbackL_ = std::tanh(wetL);  // Soft limit feedback
-        feedbackR_ = std::tanh(wetR);
+            // Process through all-pass stages
+            for (int stage = 0; stage < numStages; ++stage) {
+                wetL = stages_[stage].process(wetL, 0, coefficient);
+                wetR = stages_[stage].process(wetR, 1, coefficient);
+            }
 
-        // Mix dry/wet
-        float outL = inputL * (1.0f - dryWet) + wetL * dryWet;
-        float outR = inputR * (1.0f - dryWet) + wetR * dryWet;
+            // Store feedback (from output of all-pass chain)
+            feedbackL_ = std::tanh(wetL);  // Soft limit feedback
+            feedbackR_ = std::tanh(wetR);
 
-        buffer.setSample(0, sample, outL);
-        if (numChannels > 1)
-            buffer.setSample(1, sample, outR);
+            // Wet only; the mixer blends in the dry signal afterwards
+            buffer.setSample(0, sample, wetL);
+            if (numChannels > 1)
+                buffer.setSample(1, sample, wetR);
 
-        // Advance LFO phase
-        lfoPhase_ += lfoIncrement;
-        if (lfoPhase_ >= 1.0f) lfoPhase_ -= 1.0f;
-    }
+            // Advance LFO phase
+            lfoPhase_ += lfoIncrement;
+            if (lfoPhase_ >= 1.0f) lfoPhase_ -= 1.0f;
+        }
+    });
+
+    mixer_.mixWetSamples(buffer);
 }
 
 void Phaser::reset() {
@@ -90,39 +108,33 @@ void Phaser::reset() {
     lfoPhase_ = 0.0f;
     feedbackL_ = 0.0f;
     feedbackR_ = 0.0f;
+    mixer_.reset();
+    snapSmoothing();
 }
 
 void Phaser::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.rate = value; break;
-        case 1: params_.depth = value; break;
-        case 2: params_.feedback = value; break;
-        case 3: params_.stages = value; break;
-        case 4: params_.dryWet = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
+
+    setSmoothingTarget(index, value);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 float Phaser::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.rate;
-        case 1: return params_.depth;
-        case 2: return params_.feedback;
-        case 3: return params_.stages;
-        case 4: return params_.dryWet;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Phaser::getParameterName(int index) const {
-    static const char* names[] = {"Rate", "Depth", "Feedback", "Stages", "Dry/Wet"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<PhaserParams>(index);
 }
 
 void Phaser::setParams(const PhaserParams& params) {
     params_ = params;
+    for (int i = 0; i < getNumParameters(); ++i) {
+        setSmoothingTarget(i, getParameter(i));
+    }
+    mixer_.setWetMix(params_.dryWet);
 }
 
 } // namespace incant
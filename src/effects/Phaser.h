@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterMapping.h"
 #include <array>
 
 namespace incant {
@@ -17,7 +18,7 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<PhaserParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const PhaserParams& params);
@@ -44,12 +45,17 @@ private:
     static constexpr int kMaxStages = 12;
     std::array<AllPassStage, kMaxStages> stages_;
 
+    // All-pass coefficient across the 100Hz-4kHz sweep, built in prepare()
+    MappingTable<1024> sweepCoefficients_;
+
     // LFO phase
     float lfoPhase_ = 0.0f;
 
     // Feedback state
     float feedbackL_ = 0.0f;
     float feedbackR_ = 0.0f;
+
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterDescriptors.h"
 
 namespace incant {
 
@@ -16,7 +17,7 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<ReverbParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const ReverbParams& params);
@@ -32,6 +33,8 @@ private:
     juce::AudioBuffer<float> predelayBuffer_;
     int predelayWritePos_ = 0;
     int predelaySamples_ = 0;
+
+    DryWetMixer mixer_;
 };
 
 } // namespace incant
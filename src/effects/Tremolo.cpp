@@ -4,11 +4,20 @@
 namespace incant {
 
 Tremolo::Tremolo() {
+    setSmoothing(0, Ramp::Linear, 50.0f, params_.rate);
+    setSmoothing(1, Ramp::Linear, 50.0f, params_.depth);
+    setSmoothing(2, Ramp::Linear, 50.0f, params_.shape);
+    setSmoothing(3, Ramp::Linear, 50.0f, params_.stereo);
 }
 
 void Tremolo::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
     blockSize_ = samplesPerBlock;
+
+    prepareSmoothing(sampleRate);
+    mixer_.prepare(sampleRate, samplesPerBlock);
+    mixer_.setWetMix(params_.dryWet);
+
     reset();
 }
 
@@ -16,48 +25,50 @@ void Tremolo::process(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
     const int numChannels = std::min(buffer.getNumChannels(), 2);
 
-    // LFO rate: 1 to 20 Hz
-    float lfoFreq = 1.0f + params_.rate * 19.0f;
-    float lfoIncrement = lfoFreq / static_cast<float>(sampleRate_);
-
-    float depth = params_.depth;
-    float dryWet = params_.dryWet;
-
-    // Stereo phase offset (0 = mono, 0.5 = opposite phase)
-    float stereoOffset = params_.stereo * 0.5f;
-
-    for (int sample = 0; sample < numSamples; ++sample) {
-        // Get LFO values for each channel
-        float lfoL = getLfoValue(lfoPhaseL_, params_.shape);
-        float lfoR = getLfoValue(lfoPhaseR_, params_.shape);
-
-        // Convert LFO (-1 to 1) to gain modulation
-        // At depth=1, goes from 0 to 1. At depth=0, stays at 1.
-        float gainL = 1.0f - depth * (0.5f - 0.5f * lfoL);
-        float gainR = 1.0f - depth * (0.5f - 0.5f * lfoR);
-
-        // Get input samples
-        float inputL = buffer.getSample(0, sample);
-        float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
-
-        // Apply tremolo
-        float wetL = inputL * gainL;
-        float wetR = inputR * gainR;
-
-        // Mix dry/wet
-        float outL = inputL * (1.0f - dryWet) + wetL * dryWet;
-        float outR = inputR * (1.0f - dryWet) + wetR * dryWet;
-
-        buffer.setSample(0, sample, outL);
-        if (numChannels > 1)
-            buffer.setSample(1, sample, outR);
-
-        // Advance LFO phases
-        lfoPhaseL_ += lfoIncrement;
-        lfoPhaseR_ += lfoIncrement;
-        if (lfoPhaseL_ >= 1.0f) lfoPhaseL_ -= 1.0f;
-        if (lfoPhaseR_ >= 1.0f) lfoPhaseR_ -= 1.0f;
-    }
+    mixer_.pushDrySamples(buffer);
+
+    processSmoothed(numSamples, [&](int start, int count) {
+        // Rate and shape follow at control rate, depth and stereo per sample.
+        // LFO rate: 1 to 20 Hz
+        const float lfoIncrement = (1.0f + smoothedValue(0) * 19.0f) / static_cast<float>(sampleRate_);
+        const float shape = smoothedValue(2);
+        const float* depthRamp = smoothedRamp(1);
+        const float* stereoRamp = smoothedRamp(3);
+        const float steadyDepth = smoothedValue(1);
+        const float steadyStereo = smoothedValue(3);
+
+        for (int sample = start; sample < start + count; ++sample) {
+            const float depth = depthRamp != nullptr ? depthRamp[sample - start] : steadyDepth;
+
+            // Stereo phase offset (0 = mono, 0.5 = opposite phase)
+            float phaseR = lfoPhase_ + (stereoRamp != nullptr ? stereoRamp[sample - start] : steadyStereo) * 0.5f;
+            if (phaseR >= 1.0f) phaseR -= 1.0f;
+
+            // Get LFO values for each channel
+            float lfoL = getLfoValue(lfoPhase_, shape);
+            float lfoR = getLfoValue(phaseR, shape);
+
+            // Convert LFO (-1 to 1) to gain modulation
+            // At depth=1, goes from 0 to 1. At depth=0, stays at 1.
+            float gainL = 1.0f - depth * (0.5f - 0.5f * lfoL);
+            float gainR = 1.0f - depth * (0.5f - 0.5f * lfoR);
+
+            // Get input samples
+            float inputL = buffer.getSample(0, sample);
+            float inputR = numChannels > 1 ? buffer.getSample(1, sample) : inputL;
+
+            // Apply tremolo (wet only; the mixer blends in the dry signal afterwards)
+            buffer.setSample(0, sample, inputL * gainL);
+            if (numChannels > 1)
+                buffer.setSample(1, sample, inputR * gainR);
+
+            // Advance LFO phase
+            lfoPhase_ += lfoIncrement;
+            if (lfoPhase_ >= 1.0f) lfoPhase_ -= 1.0f;
+        }
+    });
+
+    mixer_.mixWetSamples(buffer);
 }
 
 float Tremolo::getLfoValue(float phase, float shape) {
@@ -84,51 +95,34 @@ float Tremolo::getLfoValue(float phase, float shape) {
 }
 
 void Tremolo::reset() {
-    lfoPhaseL_ = 0.0f;
-    // Apply stereo offset
-    lfoPhaseR_ = params_.stereo * 0.5f;
-    if (lfoPhaseR_ >= 1.0f) lfoPhaseR_ -= 1.0f;
+    lfoPhase_ = 0.0f;
+    mixer_.reset();
+    snapSmoothing();
 }
 
 void Tremolo::setParameter(int index, float value) {
     value = juce::jlimit(0.0f, 1.0f, value);
 
-    switch (index) {
-        case 0: params_.rate = value; break;
-        case 1: params_.depth = value; break;
-        case 2: params_.shape = value; break;
-        case 3:
-            params_.stereo = value;
-            // Update stereo phase offset
-            lfoPhaseR_ = lfoPhaseL_ + value * 0.5f;
-            if (lfoPhaseR_ >= 1.0f) lfoPhaseR_ -= 1.0f;
-            break;
-        case 4: params_.dryWet = value; break;
-    }
+    if (!setParameterValue(params_, index, value)) return;
+
+    setSmoothingTarget(index, value);
+    mixer_.setWetMix(params_.dryWet);
 }
 
 float Tremolo::getParameter(int index) const {
-    switch (index) {
-        case 0: return params_.rate;
-        case 1: return params_.depth;
-        case 2: return params_.shape;
-        case 3: return params_.stereo;
-        case 4: return params_.dryWet;
-    }
-    return 0.0f;
+    return getParameterValue(params_, index);
 }
 
 const char* Tremolo::getParameterName(int index) const {
-    static const char* names[] = {"Rate", "Depth", "Shape", "Stereo", "Dry/Wet"};
-    if (index >= 0 && index < 5) return names[index];
-    return "";
+    return parameterName<TremoloParams>(index);
 }
 
 void Tremolo::setParams(const TremoloParams& params) {
     params_ = params;
-    // Update stereo phase
-    lfoPhaseR_ = lfoPhaseL_ + params_.stereo * 0.5f;
-    if (lfoPhaseR_ >= 1.0f) lfoPhaseR_ -= 1.0f;
+    for (int i = 0; i < getNumParameters(); ++i) {
+        setSmoothingTarget(i, getParameter(i));
+    }
+    mixer_.setWetMix(params_.dryWet);
 }
 
 } // namespace incant
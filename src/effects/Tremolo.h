@@ -1,7 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
-#include "../ParameterSchema.h"
+#include "DryWetMixer.h"
+#include "../ParameterDescriptors.h"
 
 namespace incant {
 
@@ -16,7 +17,7 @@ public:
 
     void setParameter(int index, float value) override;
     float getParameter(int index) const override;
-    int getNumParameters() const override { return 5; }
+    int getNumParameters() const override { return numParameters<TremoloParams>(); }
     const char* getParameterName(int index) const override;
 
     void setParams(const TremoloParams& params);
@@ -26,9 +27,11 @@ private:
 
     TremoloParams params_;
 
-    // LFO phase (stereo phases for pan tremolo)
-    float lfoPhaseL_ = 0.0f;
-    float lfoPhaseR_ = 0.0f;
+    // LFO phase of the left channel; the right one runs the (smoothed)
+    // stereo offset ahead of it
+    float lfoPhase_ = 0.0f;
+
+    DryWetMixer mixer_;
 };
 
 } // namespace incant